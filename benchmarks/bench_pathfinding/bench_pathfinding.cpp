@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "graphalg/gridgraph.h"
+#include "graphalg/a_star_search.h"
+#include "graphalg/heuristics.h"
+#include "graphalg/jump_point_search.h"
+#include "graphalg/bidirectional_search.h"
+#include "graphalg/hierarchical_graph.h"
+#include "graphalg/first_move_table.h"
+#include "graphalg/landmarks.h"
+#include "graphalg/nearest_target.h"
+#include "graphalg/bitboard.h"
+#include "graphalg/compact_path.h"
+#include "graphalg/search_stats.h"
+#include "graphalg/region_boundaries.h"
+
+const size_t MAP_WIDTH = 256;
+const size_t MAP_HEIGHT = 256;
+const size_t QUERIES = 200;
+
+class BenchNode {
+public:
+    BenchNode(bool passable, uint8_t move_cost) : m_passable(passable), m_move_cost(move_cost), m_region(0) {};
+
+    bool passable() const { return m_passable; };
+    uint8_t move_cost() const { return m_move_cost; };
+    uint32_t region() const { return m_region; };
+    void set_region(uint32_t reg) { m_region = reg; };
+    void clear_region() { m_region = 0; };
+
+private:
+    bool m_passable;
+    uint8_t m_move_cost;
+    uint32_t m_region;
+};
+
+using BenchGrid = GridGraph<BenchNode, MAP_WIDTH, MAP_HEIGHT>;
+using OctileGrid = GridGraph<BenchNode, MAP_WIDTH, MAP_HEIGHT, 8>;
+using Query = std::pair<GridLocation, GridLocation>;
+
+int manhattan(GridLocation a, GridLocation b)
+{
+    int x1, y1, x2, y2;
+    std::tie(x1, y1) = a;
+    std::tie(x2, y2) = b;
+    return abs(x1 - x2) + abs(y1 - y2);
+}
+
+// Grass with scattered rectangular lakes and patches of shallow water.
+std::string generate_map(std::mt19937& rng, int shallows = 0)
+{
+    std::vector<char> water(MAP_WIDTH * MAP_HEIGHT, 0);
+    std::uniform_int_distribution<int> pos_x(0, MAP_WIDTH - 1), pos_y(0, MAP_HEIGHT - 1), extent(1, 12);
+    for (int lake = 0; lake < 600; lake++) {
+        int x0(pos_x(rng)), y0(pos_y(rng)), w(extent(rng)), h(extent(rng));
+        for (int y = y0; y < y0 + h && y < static_cast<int>(MAP_HEIGHT); y++) {
+            for (int x = x0; x < x0 + w && x < static_cast<int>(MAP_WIDTH); x++) {
+                water[y * MAP_WIDTH + x] = 1;
+            }
+        }
+    }
+    for (int patch = 0; patch < shallows; patch++) {
+        int x0(pos_x(rng)), y0(pos_y(rng)), w(extent(rng)), h(extent(rng));
+        for (int y = y0; y < y0 + h && y < static_cast<int>(MAP_HEIGHT); y++) {
+            for (int x = x0; x < x0 + w && x < static_cast<int>(MAP_WIDTH); x++) {
+                water[y * MAP_WIDTH + x] = water[y * MAP_WIDTH + x] ? 1 : 2;
+            }
+        }
+    }
+
+    std::ostringstream map;
+    for (size_t y = 0; y < MAP_HEIGHT; y++) {
+        for (size_t x = 0; x < MAP_WIDTH; x++) {
+            static const char* const TOKENS[] = {"1", "2", "3"};
+            map << TOKENS[static_cast<int>(water[y * MAP_WIDTH + x])] << (x + 1 < MAP_WIDTH ? " " : "\n");
+        }
+    }
+    return map.str();
+}
+
+// Random start/goal pairs sharing a region, like World::get_path requires.
+std::vector<Query> generate_queries(const BenchGrid& graph, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> pos_x(0, MAP_WIDTH - 1), pos_y(0, MAP_HEIGHT - 1);
+    std::vector<Query> queries;
+    while (queries.size() < QUERIES) {
+        GridLocation start(pos_x(rng), pos_y(rng)), goal(pos_x(rng), pos_y(rng));
+        auto start_node = graph.at(std::get<0>(start), std::get<1>(start));
+        auto goal_node = graph.at(std::get<0>(goal), std::get<1>(goal));
+        if (start_node->passable() && start_node->region() == goal_node->region()) {
+            queries.emplace_back(start, goal);
+        }
+    }
+    return queries;
+}
+
+template<typename Graph>
+void load_map(Graph& graph, const std::string& map)
+{
+    std::istringstream stream(map);
+    graph.load(stream, [](std::string token) -> std::unique_ptr<BenchNode> {
+        std::unique_ptr<BenchNode> node(new BenchNode(token != "2", token == "3" ? 3 : 1));
+        return node;
+    });
+}
+
+template<typename Search>
+void run(const char* name, const std::vector<Query>& queries, Search search, const char* counted = "path nodes")
+{
+    size_t total_length(0);
+    auto begin = std::chrono::steady_clock::now();
+    for (auto& query : queries) {
+        total_length += search(query.first, query.second).size();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+    printf("%-48s %8.2f ms %10.1f us/query  (%s: %zu)\n",
+           name, ms, ms * 1000 / queries.size(), counted, total_length);
+}
+
+int main(int argc, char* argv[])
+{
+    std::mt19937 rng(42);
+    std::mt19937 map_rng(rng), weighted_rng(rng);
+    std::unique_ptr<BenchGrid> graph(new BenchGrid);
+    load_map(*graph, generate_map(rng));
+    auto queries = generate_queries(*graph, rng);
+
+    printf("%zux%zu grid, %zu queries\n", MAP_WIDTH, MAP_HEIGHT, queries.size());
+
+    SearchWorkspace<int, PriorityQueue<NodeIndex, int> > heap_workspace;
+    run("a_star/binary_heap", queries, [&](GridLocation start, GridLocation goal) {
+        return a_star_search(*graph, start, goal, manhattan, heap_workspace);
+    });
+
+    SearchWorkspace<int, BucketQueue<int> > bucket_workspace;
+    run("a_star/bucket_queue", queries, [&](GridLocation start, GridLocation goal) {
+        return a_star_search(*graph, start, goal, manhattan, bucket_workspace);
+    });
+
+    // Same search, only the way the heuristic is called differs.
+    std::function<int(GridLocation, GridLocation)> manhattan_function = manhattan;
+    run("a_star/bucket_queue/std_function", queries, [&](GridLocation start, GridLocation goal) {
+        return a_star_search(*graph, start, goal, manhattan_function, bucket_workspace);
+    });
+    run("a_star/bucket_queue/inlined", queries, [&](GridLocation start, GridLocation goal) {
+        return a_star_search(*graph, start, goal, ManhattanHeuristic<>(), bucket_workspace);
+    });
+
+    // The same again, counting its work as a SEARCH_STATS build would.
+    SearchWorkspace<int, BucketQueue<int>, SearchRecorder<true> > recording_workspace;
+    SearchStats stats;
+    run("a_star/bucket_queue/inlined/recorded", queries, [&](GridLocation start, GridLocation goal) {
+        auto path = a_star_search(*graph, start, goal, ManhattanHeuristic<>(), recording_workspace);
+        stats += recording_workspace.stats.stats();
+        return path;
+    });
+    printf("%-48s %zu expanded, %zu pushes (%zu duplicate), %zu pops, %.2f ms searching\n", "search stats per query",
+           stats.expanded / stats.searches, stats.pushes / stats.searches,
+           stats.duplicates / stats.searches, stats.pops / stats.searches, stats.ms);
+
+    LandmarkHeuristic<BenchGrid> landmarks(4);
+    landmarks.build(*graph);
+    std::function<int(GridLocation, GridLocation)> alt = std::cref(landmarks);
+    run("a_star/bucket_queue/alt", queries, [&](GridLocation start, GridLocation goal) {
+        return a_star_search(*graph, start, goal, alt, bucket_workspace);
+    });
+
+    SearchWorkspace<int, BucketQueue<int> > backward_workspace;
+    run("bidirectional/bucket_queue", queries, [&](GridLocation start, GridLocation goal) {
+        return bidirectional_search(*graph, start, goal, manhattan, bucket_workspace, backward_workspace);
+    });
+    run("bidirectional/parallel", queries, [&](GridLocation start, GridLocation goal) {
+        return bidirectional_search(*graph, start, goal, manhattan, bucket_workspace, backward_workspace, true);
+    });
+
+    run("jump_point/bucket_queue", queries, [&](GridLocation start, GridLocation goal) {
+        return jump_point_search(*graph, start, goal, manhattan, bucket_workspace);
+    });
+
+    // What the same paths take to keep, a tile per step or compact.
+    size_t step_bytes(0), compact_bytes(0);
+    for (auto& query : queries) {
+        auto path = jump_point_search(*graph, query.first, query.second, manhattan, bucket_workspace);
+        step_bytes += sizeof(path) + path.capacity() * sizeof(GridLocation);
+        compact_bytes += CompactPath::from_waypoints(path).bytes();
+    }
+    printf("%-48s %zu bytes/path as steps, %zu bytes/path compact\n", "path memory",
+           step_bytes / queries.size(), compact_bytes / queries.size());
+
+    HierarchicalGraph<BenchGrid> hierarchy(16);
+    hierarchy.build(*graph);
+    run("hierarchical/16x16", queries, [&](GridLocation start, GridLocation goal) {
+        return hierarchy.find_path(start, goal);
+    });
+
+    // The same map with diagonal moves.
+    std::unique_ptr<OctileGrid> octile_graph(new OctileGrid);
+    load_map(*octile_graph, generate_map(map_rng));
+    run("a_star/bucket_queue/8_connected", queries, [&](GridLocation start, GridLocation goal) {
+        return a_star_search(*octile_graph, start, goal, OctileGrid::Heuristic(), bucket_workspace);
+    });
+    run("jump_point/bucket_queue/8_connected", queries, [&](GridLocation start, GridLocation goal) {
+        return jump_point_search(*octile_graph, start, goal, OctileGrid::Heuristic(), bucket_workspace);
+    });
+
+    // The same lakes with shallow water on the grass.
+    std::unique_ptr<BenchGrid> weighted_graph(new BenchGrid);
+    load_map(*weighted_graph, generate_map(weighted_rng, 300));
+    run("a_star/bucket_queue/inlined/weighted", queries, [&](GridLocation start, GridLocation goal) {
+        return a_star_search(*weighted_graph, start, goal, ManhattanHeuristic<>(), bucket_workspace);
+    });
+    // Same costs, read from the nodes the way the cost grid avoids.
+    auto node_cost = [](const BenchGrid& grid, GridLocation from, GridLocation to) {
+        return (grid.at(std::get<0>(from), std::get<1>(from))->move_cost() +
+                grid.at(std::get<0>(to), std::get<1>(to))->move_cost()) / 2;
+    };
+    run("a_star/bucket_queue/inlined/weighted/node_costs", queries, [&](GridLocation start, GridLocation goal) {
+        return a_star_search(*weighted_graph, start, goal, ManhattanHeuristic<>(), bucket_workspace, node_cost);
+    });
+    run("jump_point/bucket_queue/weighted", queries, [&](GridLocation start, GridLocation goal) {
+        return jump_point_search(*weighted_graph, start, goal, manhattan, bucket_workspace);
+    });
+
+    // Paths to the nearest of a few goals around each query's goal.
+    std::vector<std::vector<GridLocation> > goal_sets;
+    std::uniform_int_distribution<int> offset(-24, 24);
+    for (auto& query : queries) {
+        std::vector<GridLocation> goals;
+        for (int goal = 0; goal < 8; goal++) {
+            int x = std::get<0>(query.second) + offset(rng), y = std::get<1>(query.second) + offset(rng);
+            x = std::min(std::max(x, 0), static_cast<int>(MAP_WIDTH) - 1);
+            y = std::min(std::max(y, 0), static_cast<int>(MAP_HEIGHT) - 1);
+            goals.emplace_back(x, y);
+        }
+        goal_sets.push_back(goals);
+    }
+    size_t goal_set = 0;
+    run("nearest_of_set/path_to_nearest", queries, [&](GridLocation start, GridLocation) {
+        return path_to_nearest(*graph, start, goal_sets[goal_set++ % goal_sets.size()],
+                               ManhattanHeuristic<>(), bucket_workspace);
+    });
+
+    // Orders onto water, ending at the closest tile the start can reach.
+    std::vector<GridLocation> water_goals;
+    std::uniform_int_distribution<int> pos_x(0, MAP_WIDTH - 1), pos_y(0, MAP_HEIGHT - 1);
+    while (water_goals.size() < queries.size()) {
+        GridLocation goal(pos_x(rng), pos_y(rng));
+        if (!graph->passable(goal)) {
+            water_goals.push_back(goal);
+        }
+    }
+    auto begin = std::chrono::steady_clock::now();
+    RegionBoundaries<BenchGrid> boundaries;
+    boundaries.build(*graph);
+    printf("region boundaries: built in %.2f ms\n",
+           std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+    size_t water_goal = 0;
+    auto closest = [&](GridLocation start) {
+        GridLocation tile;
+        boundaries.closest(*graph, graph->at(std::get<0>(start), std::get<1>(start))->region(),
+                           water_goals[water_goal++ % water_goals.size()], tile);
+        return tile;
+    };
+    run("closest_reachable/region_boundaries", queries, [&](GridLocation start, GridLocation) {
+        return std::vector<GridLocation>(1, closest(start));
+    }, "tiles");
+    run("closest_reachable/region_boundaries+jump_point", queries, [&](GridLocation start, GridLocation) {
+        return jump_point_search(*graph, start, closest(start), manhattan, bucket_workspace);
+    });
+
+    // Distance fields from every query start.
+    run("distance_field/dijkstra", queries, [&](GridLocation start, GridLocation) {
+        dijkstra(*graph, {graph->index(start)}, bucket_workspace);
+        std::vector<int> reached;
+        for (NodeIndex idx = 0; idx < graph->size(); idx++) {
+            if (bucket_workspace.reached(idx)) {
+                reached.push_back(bucket_workspace.cost(idx));
+            }
+        }
+        return reached;
+    }, "reached tiles");
+    run("distance_field/bitboard", queries, [&](GridLocation start, GridLocation) {
+        std::vector<int> distances, reached;
+        bitbfs::distance_field(graph->passable_bits(), start, distances);
+        for (auto distance : distances) {
+            if (distance >= 0) {
+                reached.push_back(distance);
+            }
+        }
+        return reached;
+    }, "reached tiles");
+
+    // One Dijkstra per tile: takes minutes on this map with few cores.
+    if (argc > 1 && std::string(argv[1]) == "--first-move-table") {
+        FirstMoveTable<BenchGrid> first_moves;
+        auto build_begin = std::chrono::steady_clock::now();
+        first_moves.build(*graph);
+        auto build_end = std::chrono::steady_clock::now();
+        printf("first move table: %zu runs, built in %.0f ms\n", first_moves.run_count(),
+               std::chrono::duration<double, std::milli>(build_end - build_begin).count());
+        run("first_move_table", queries, [&](GridLocation start, GridLocation goal) {
+            return first_moves.find_path(start, goal);
+        });
+    }
+
+    return 0;
+}
@@ -53,10 +53,9 @@ int App::execute()
             if (event.type == SDL_QUIT) {
                 done = true;
             }
+            world->handle_event(event);
         }
 
-        world->handle_event(event);
-
         world->update(elapsed);
         world->render();
     }
@@ -0,0 +1,69 @@
+#include "follow_path_command.h"
+#include "../lifeform.h"
+#include "../worldposition.h"
+#include "../gameconstants.h"
+
+FollowPathCommand::FollowPathCommand(LifeForm* actor, const CompactPath &path)
+    : Command(actor)
+    , m_path(path)
+    , m_next_move(0)
+    , m_target(path.start())
+    , m_wait(0)
+{
+    m_done = m_path.empty();
+}
+
+uint32_t FollowPathCommand::update(uint32_t elapsed)
+{
+    while (!m_done) {
+        if (m_wait > 0) {
+            if (elapsed < m_wait) {
+                m_wait -= elapsed;
+                return 0;
+            }
+            elapsed -= m_wait;
+            m_wait = 0;
+        } else if (!walk(elapsed)) {
+            return 0;
+        }
+        next_waypoint();
+    }
+
+    return elapsed;
+}
+
+// Moves towards the centre of the target tile. Returns whether it got
+// there, leaving the time that is left in elapsed.
+bool FollowPathCommand::walk(uint32_t &elapsed)
+{
+    int x, y;
+    std::tie(x, y) = m_target;
+    const WorldPosition goal(x * TILE_WIDTH + TILE_WIDTH/2, y * TILE_HEIGHT + TILE_HEIGHT/2);
+    const double velocity = LIFEFORM_VELOCITY;
+    double movement = velocity * elapsed;
+    auto current = m_actor->get_pos();
+    auto diff = geom::substruct(goal, current);
+    double distance = diff.abs();
+    if (movement < distance) {
+        m_actor->move_to(geom::sum(current, geom::scale(diff, movement/distance)));
+        elapsed = 0;
+        return false;
+    }
+    m_actor->move_to(goal);
+    elapsed = (movement - distance)/velocity;
+    return true;
+}
+
+void FollowPathCommand::next_waypoint()
+{
+    if (m_next_move == m_path.moves()) {
+        m_done = true;
+        return;
+    }
+    const auto& move = m_path.move(m_next_move++);
+    if (move.is_wait()) {
+        m_wait = LIFEFORM_STEP_TIME;
+    } else {
+        m_target = GridLocation(std::get<0>(m_target) + move.dx, std::get<1>(m_target) + move.dy);
+    }
+}
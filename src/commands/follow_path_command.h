@@ -0,0 +1,25 @@
+#ifndef FOLLOW_PATH_COMMAND_H
+#define FOLLOW_PATH_COMMAND_H
+
+#include "command.h"
+#include "../graphalg/compact_path.h"
+
+// Walks the actor along a path from one tile centre to the next.
+class FollowPathCommand : public Command
+{
+public:
+    FollowPathCommand(LifeForm* actor, const CompactPath &path);
+
+    uint32_t update(uint32_t elapsed) override;
+
+private:
+    bool walk(uint32_t &elapsed);
+    void next_waypoint();
+
+    CompactPath m_path;
+    size_t m_next_move;
+    GridLocation m_target;
+    uint32_t m_wait;
+};
+
+#endif // FOLLOW_PATH_COMMAND_H
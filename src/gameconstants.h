@@ -3,8 +3,12 @@
 
 #define WORLD_WIDTH 50
 #define WORLD_HEIGHT 50
+#define WORLD_CONNECTIVITY 8 // 4 or 8 directions to move in
 
 #define TILE_WIDTH 16
 #define TILE_HEIGHT 16
 
+#define LIFEFORM_VELOCITY 0.03 // pixels per ms
+#define LIFEFORM_STEP_TIME 533 // ms to cross a tile
+
 #endif // GAMECONSTANTS_H
@@ -1,71 +1,136 @@
 #ifndef A_STAR_SEARCH
 #define A_STAR_SEARCH
 
-#include <queue>
-#include <unordered_map>
+#include <tuple>
+#include <vector>
 #include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include "search_workspace.h"
+#include "bucket_queue.h"
 
-template<typename T, typename Number=int>
-struct PriorityQueue {
-    using PQElement = std::pair<Number, T>;
-    std::priority_queue<PQElement, std::vector<PQElement>,
-                        std::greater<PQElement>> elements;
-
-    inline bool empty() { return elements.empty(); }
-
-    inline void put(T item, Number priority) {
-        elements.emplace(priority, item);
+// Default policies, asking the graph itself.
+struct GraphCost {
+    template<typename Graph, typename Node>
+    inline int operator()(const Graph& graph, const Node& from, const Node& to) const {
+        return graph.cost(from, to);
     }
+};
 
-    inline T get() {
-        T best_item = elements.top().second;
-        elements.pop();
-        return best_item;
+struct GraphNeighbors {
+    template<typename Graph, typename Node, typename Visitor>
+    inline void operator()(const Graph& graph, const Node& node, Visitor visit) const {
+        graph.for_each_neighbor(node, visit);
     }
 };
 
-template<typename Graph>
+// Policies are template parameters so that the inner loop inlines them.
+template<typename Graph, typename Workspace, typename Heuristic,
+         typename Cost = GraphCost, typename Neighbors = GraphNeighbors>
 std::vector<typename Graph::Node> a_star_search(const Graph &graph,
                                                 typename Graph::Node start,
                                                 typename Graph::Node goal,
-                                                std::function<int(typename Graph::Node, typename Graph::Node)> heuristic)
+                                                Heuristic heuristic,
+                                                Workspace &workspace,
+                                                Cost cost = Cost(),
+                                                Neighbors neighbors = Neighbors())
 {
-    std::unordered_map<typename Graph::Node, typename Graph::Node> came_from;
-    std::unordered_map<typename Graph::Node, int> cost_so_far;
-    PriorityQueue<typename Graph::Node> frontier;
+    const NodeIndex start_idx = graph.index(start);
+    const NodeIndex goal_idx = graph.index(goal);
+    auto &frontier = workspace.frontier;
 
-    frontier.put(start, 0);
-    came_from[start] = start;
-    cost_so_far[start] = 0;
+    workspace.reset(graph.size());
+    workspace.relax(start_idx, 0, start_idx);
+    frontier.put(start_idx, 0);
 
     while (!frontier.empty()) {
         auto current = frontier.get();
+        workspace.stats.popped();
 
-        if (current == goal) {
+        if (current == goal_idx) {
             break;
         }
 
-        for (auto next : graph.neighbors(current)) {
-            int new_cost = cost_so_far[current] + graph.cost(current, next);
-            if (!cost_so_far.count(next) || new_cost < cost_so_far[next]) {
-                cost_so_far[next] = new_cost;
+        workspace.stats.expanded();
+        auto current_loc = graph.location(current);
+        neighbors(graph, current_loc, [&](const typename Graph::Node& next) {
+            NodeIndex next_idx = graph.index(next);
+            int new_cost = workspace.cost(current) + cost(graph, current_loc, next);
+            const bool reached = workspace.reached(next_idx);
+            if (!reached || new_cost < workspace.cost(next_idx)) {
+                workspace.relax(next_idx, new_cost, current);
                 int priority = new_cost + heuristic(next, goal);
-                frontier.put(next, priority);
-                came_from[next] = current;
+                frontier.put(next_idx, priority);
+                workspace.stats.pushed(reached);
             }
-        }
+        });
     }
-
     // Generate path
     std::vector<typename Graph::Node> path;
-    auto current = goal;
-    path.push_back(current);
-    while (current != start) {
-        current = came_from[current];
-        path.push_back(current);
+    if (!workspace.reached(goal_idx)) {
+        workspace.stats.end(0);
+        return path;
+    }
+    auto current = goal_idx;
+    path.push_back(goal);
+    while (current != start_idx) {
+        current = workspace.came_from(current);
+        path.push_back(graph.location(current));
     }
     std::reverse(path.begin(), path.end());
+    workspace.stats.end(path.size());
     return path;
 }
 
+template<typename OpenList=PriorityQueue<NodeIndex, int>, typename Graph, typename Heuristic>
+std::vector<typename Graph::Node> a_star_search(const Graph &graph,
+                                                typename Graph::Node start,
+                                                typename Graph::Node goal,
+                                                Heuristic heuristic)
+{
+    SearchWorkspace<int, OpenList> workspace;
+    return a_star_search(graph, start, goal, heuristic, workspace);
+}
+
+struct VisitAll {
+    inline bool operator()(NodeIndex) const { return true; }
+};
+
+// Dijkstra from all of sources, nearest first until visit(idx) is false.
+template<typename Graph, typename Workspace, typename Visit = VisitAll>
+void dijkstra(const Graph &graph,
+              std::initializer_list<NodeIndex> sources,
+              Workspace &workspace,
+              Visit visit = Visit())
+{
+    auto &frontier = workspace.frontier;
+    workspace.reset(graph.size());
+    for (auto source : sources) {
+        workspace.relax(source, 0, source);
+        frontier.put(source, 0);
+    }
+
+    while (!frontier.empty()) {
+        auto current = frontier.get();
+        workspace.stats.popped();
+        if (!visit(current)) {
+            break;
+        }
+
+        workspace.stats.expanded();
+        auto current_loc = graph.location(current);
+        graph.for_each_neighbor(current_loc, [&](const typename Graph::Node& next) {
+            NodeIndex next_idx = graph.index(next);
+            int new_cost = workspace.cost(current) + graph.cost(current_loc, next);
+            const bool reached = workspace.reached(next_idx);
+            if (!reached || new_cost < workspace.cost(next_idx)) {
+                workspace.relax(next_idx, new_cost, current);
+                frontier.put(next_idx, new_cost);
+                workspace.stats.pushed(reached);
+            }
+        });
+    }
+    workspace.stats.end(0);
+}
+
 #endif // A_STAR_SEARCH
@@ -0,0 +1,73 @@
+#ifndef ANY_ANGLE_H
+#define ANY_ANGLE_H
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include "gridlocation.h"
+
+// Calls visit(x, y) for every tile a square of half side half_size touches
+// moving from a to b, until visit returns false.
+template<typename Visitor>
+bool walk_line(const GridLocation& a, const GridLocation& b, Visitor visit, double half_size = 0)
+{
+    int ax, ay, bx, by;
+    std::tie(ax, ay) = a;
+    std::tie(bx, by) = b;
+    // A bit more, so that rounding never misses a touch.
+    const double reach = half_size + 0.5 + 1e-9;
+    const int last_x = static_cast<int>(std::floor(std::max(ax, bx) + reach));
+    for (int x = static_cast<int>(std::ceil(std::min(ax, bx) - reach)); x <= last_x; x++) {
+        // The part of the way within reach of column x.
+        double t0 = 0, t1 = 1;
+        if (ax != bx) {
+            t0 = (x - reach - ax) / (bx - ax);
+            t1 = (x + reach - ax) / (bx - ax);
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            t0 = std::max(t0, 0.0);
+            t1 = std::min(t1, 1.0);
+        }
+        const double y0 = ay + t0 * (by - ay), y1 = ay + t1 * (by - ay);
+        const int last_y = static_cast<int>(std::floor(std::max(y0, y1) + reach));
+        for (int y = static_cast<int>(std::ceil(std::min(y0, y1) - reach)); y <= last_y; y++) {
+            if (!visit(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Only over tiles of a's terrain cost, keeping clearance tiles around.
+template<typename Graph>
+bool line_of_sight(const Graph& graph, const GridLocation& a, const GridLocation& b, double clearance = 0)
+{
+    const int cost = graph.move_cost(a);
+    return walk_line(a, b, [&graph, cost](int x, int y) {
+        GridLocation loc(x, y);
+        return graph.in_bounds(loc) && graph.passable(loc) && graph.move_cost(loc) == cost;
+    }, clearance);
+}
+
+// String pulling: keeps the tiles where a grid path turns around obstacles.
+template<typename Graph>
+std::vector<GridLocation> smooth_path(const Graph& graph, const std::vector<GridLocation>& path, double clearance = 0)
+{
+    if (path.size() < 3) {
+        return path;
+    }
+
+    std::vector<GridLocation> result {path.front()};
+    for (size_t next = 2; next < path.size(); next++) {
+        if (!line_of_sight(graph, result.back(), path[next], clearance)) {
+            result.push_back(path[next - 1]);
+        }
+    }
+    result.push_back(path.back());
+    return result;
+}
+
+#endif // ANY_ANGLE_H
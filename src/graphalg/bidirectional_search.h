@@ -0,0 +1,159 @@
+#ifndef BIDIRECTIONAL_SEARCH_H
+#define BIDIRECTIONAL_SEARCH_H
+
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "search_workspace.h"
+
+// Bidirectional A* over an undirected graph, optionally a thread per side.
+namespace bidirectional {
+
+const int UNREACHED = INT_MAX;
+
+struct Meeting {
+    std::mutex mutex;
+    std::atomic<int> cost;
+    NodeIndex node;
+
+    Meeting() : cost(UNREACHED), node(0) {};
+
+    void offer(int candidate, NodeIndex at) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (candidate < cost) {
+            cost = candidate;
+            node = at;
+        }
+    };
+};
+
+// Per-node costs of one side, readable from the other side's thread.
+class SharedCosts
+{
+public:
+    SharedCosts(size_t size) : m_costs(new std::atomic<int>[size]) {
+        for (size_t idx = 0; idx < size; idx++) {
+            m_costs[idx] = UNREACHED;
+        }
+    };
+
+    inline int get(NodeIndex idx) const { return m_costs[idx]; };
+    inline void set(NodeIndex idx, int cost) { m_costs[idx] = cost; };
+
+private:
+    std::unique_ptr<std::atomic<int>[]> m_costs;
+};
+
+// Expands the frontier's best node. False once the meeting can't improve.
+template<typename Graph, typename Workspace, typename Heuristic, typename OtherCost, typename Relaxed>
+bool expand(const Graph &graph, typename Graph::Node target, const Heuristic &heuristic,
+            Workspace &side, OtherCost other_cost, Relaxed relaxed, Meeting &meeting)
+{
+    auto &frontier = side.frontier;
+    if (frontier.empty() || frontier.top_priority() >= meeting.cost) {
+        return false;
+    }
+
+    auto current = frontier.get();
+    side.stats.popped();
+    side.stats.expanded();
+    auto current_loc = graph.location(current);
+    graph.for_each_neighbor(current_loc, [&](const typename Graph::Node& next) {
+        NodeIndex next_idx = graph.index(next);
+        int new_cost = side.cost(current) + graph.cost(current_loc, next);
+        const bool reached = side.reached(next_idx);
+        if (!reached || new_cost < side.cost(next_idx)) {
+            side.relax(next_idx, new_cost, current);
+            relaxed(next_idx, new_cost);
+            frontier.put(next_idx, new_cost + heuristic(next, target));
+            side.stats.pushed(reached);
+            int other = other_cost(next_idx);
+            if (other != UNREACHED && new_cost + other < meeting.cost) {
+                meeting.offer(new_cost + other, next_idx);
+            }
+        }
+    });
+    return true;
+}
+
+} // namespace bidirectional
+
+template<typename Graph, typename Workspace, typename Heuristic>
+std::vector<typename Graph::Node> bidirectional_search(const Graph &graph,
+                                                       typename Graph::Node start,
+                                                       typename Graph::Node goal,
+                                                       Heuristic heuristic,
+                                                       Workspace &forward,
+                                                       Workspace &backward,
+                                                       bool parallel = false)
+{
+    using namespace bidirectional;
+    const NodeIndex start_idx = graph.index(start);
+    const NodeIndex goal_idx = graph.index(goal);
+    Meeting meeting;
+
+    forward.reset(graph.size());
+    forward.relax(start_idx, 0, start_idx);
+    forward.frontier.put(start_idx, heuristic(start, goal));
+    backward.reset(graph.size());
+    backward.relax(goal_idx, 0, goal_idx);
+    backward.frontier.put(goal_idx, heuristic(goal, start));
+    if (start_idx == goal_idx) {
+        meeting.offer(0, start_idx);
+    }
+
+    if (!parallel) {
+        auto forward_cost = [&backward](NodeIndex idx) {
+            return backward.reached(idx) ? backward.cost(idx) : UNREACHED;
+        };
+        auto backward_cost = [&forward](NodeIndex idx) {
+            return forward.reached(idx) ? forward.cost(idx) : UNREACHED;
+        };
+        auto ignore = [](NodeIndex, int) {};
+        while (expand(graph, goal, heuristic, forward, forward_cost, ignore, meeting) &&
+               expand(graph, start, heuristic, backward, backward_cost, ignore, meeting)) {
+        }
+    } else {
+        SharedCosts forward_costs(graph.size()), backward_costs(graph.size());
+        forward_costs.set(start_idx, 0);
+        backward_costs.set(goal_idx, 0);
+        std::atomic<bool> done(false);
+        auto run = [&](Workspace &side, SharedCosts &own, SharedCosts &other,
+                       typename Graph::Node target) {
+            auto other_cost = [&other](NodeIndex idx) { return other.get(idx); };
+            auto relaxed = [&own](NodeIndex idx, int cost) { own.set(idx, cost); };
+            while (!done && expand(graph, target, heuristic, side, other_cost, relaxed, meeting)) {
+            }
+            done = true;
+        };
+        std::thread backward_thread(run, std::ref(backward), std::ref(backward_costs),
+                                    std::ref(forward_costs), start);
+        run(forward, forward_costs, backward_costs, goal);
+        backward_thread.join();
+    }
+
+    // Generate path: start .. meeting node .. goal
+    std::vector<typename Graph::Node> path;
+    if (meeting.cost == UNREACHED) {
+        forward.stats.end(0);
+        return path;
+    }
+    for (auto current = meeting.node; current != start_idx; current = forward.came_from(current)) {
+        path.push_back(graph.location(current));
+    }
+    path.push_back(start);
+    std::reverse(path.begin(), path.end());
+    for (auto current = meeting.node; current != goal_idx; ) {
+        current = backward.came_from(current);
+        path.push_back(graph.location(current));
+    }
+    forward.stats.end(path.size());
+    return path;
+}
+
+#endif // BIDIRECTIONAL_SEARCH_H
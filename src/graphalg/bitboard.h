@@ -0,0 +1,205 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "gridlocation.h"
+
+// One bit per tile of a width x height grid, in 64-bit words row by row.
+template<size_t width, size_t height>
+class Bitboard
+{
+public:
+    static constexpr size_t WORDS = (width + 63) / 64; // per row
+
+    // A range of rows, empty if first > last.
+    struct Rows {
+        Rows() : first(height), last(0) {};
+        Rows(size_t first, size_t last) : first(first), last(last) {};
+        bool empty() const { return first > last; };
+
+        size_t first;
+        size_t last;
+    };
+
+    inline bool test(int x, int y) const { return m_words[word(x, y)] >> (x % 64) & 1; };
+    inline void set(int x, int y) { m_words[word(x, y)] |= uint64_t(1) << (x % 64); };
+    inline void reset(int x, int y) { m_words[word(x, y)] &= ~(uint64_t(1) << (x % 64)); };
+    bool test(const GridLocation& loc) const { return test(std::get<0>(loc), std::get<1>(loc)); };
+    void set(const GridLocation& loc) { set(std::get<0>(loc), std::get<1>(loc)); };
+
+    // Adds the bits other has within rows.
+    void merge(const Bitboard& other, Rows rows) {
+        for (size_t i = rows.first * WORDS; i < (rows.last + 1) * WORDS && i < m_words.size(); i++) {
+            m_words[i] |= other.m_words[i];
+        }
+    };
+
+    void clear_rows(Rows rows) {
+        for (size_t i = rows.first * WORDS; i < (rows.last + 1) * WORDS && i < m_words.size(); i++) {
+            m_words[i] = 0;
+        }
+    };
+
+    // One BFS step: the unvisited passable 4-neighbours of rows go to next
+    // and visited. Returns the rows next has bits in.
+    Rows advance(Rows rows, const Bitboard& passable, Bitboard& visited, Bitboard& next) const {
+        static const uint64_t NO_ROW[WORDS] = {};
+        Rows reached;
+        const size_t first = rows.first > 0 ? rows.first - 1 : 0;
+        const size_t last = std::min(rows.last + 1, height - 1);
+        for (size_t y = first; y <= last; y++) {
+            const uint64_t* row = &m_words[y * WORDS];
+            const uint64_t* above = y > 0 ? row - WORDS : NO_ROW;
+            const uint64_t* below = y + 1 < height ? row + WORDS : NO_ROW;
+            const uint64_t* open = &passable.m_words[y * WORDS];
+            uint64_t* seen = &visited.m_words[y * WORDS];
+            uint64_t* out = &next.m_words[y * WORDS];
+            uint64_t any = 0;
+            for (size_t i = 0; i < WORDS; i++) {
+                // Bit x of the row moves to x + 1 and x - 1, across words.
+                uint64_t bits = row[i] | row[i] << 1 | row[i] >> 1 | above[i] | below[i];
+                if (i > 0) {
+                    bits |= row[i - 1] >> 63;
+                }
+                if (i + 1 < WORDS) {
+                    bits |= row[i + 1] << 63;
+                }
+                bits &= open[i] & ~seen[i];
+                out[i] = bits;
+                seen[i] |= bits;
+                any |= bits;
+            }
+            if (any) {
+                reached.first = std::min(reached.first, y);
+                reached.last = y;
+            }
+        }
+        return reached;
+    };
+
+    // The first bit within rows that other has too, row by row.
+    bool first_common(const Bitboard& other, Rows rows, GridLocation& loc) const {
+        for (size_t i = rows.first * WORDS; i < (rows.last + 1) * WORDS && i < m_words.size(); i++) {
+            if (uint64_t bits = m_words[i] & other.m_words[i]) {
+                loc = GridLocation(i % WORDS * 64 + __builtin_ctzll(bits), i / WORDS);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Calls visit(x, y) for every set bit, row by row.
+    template<typename Visitor>
+    void for_each(Visitor visit, Rows rows = Rows(0, height - 1)) const {
+        for (size_t i = rows.first * WORDS; i < (rows.last + 1) * WORDS && i < m_words.size(); i++) {
+            for (uint64_t bits = m_words[i]; bits; bits &= bits - 1) {
+                visit(static_cast<int>(i % WORDS * 64 + __builtin_ctzll(bits)), static_cast<int>(i / WORDS));
+            }
+        }
+    }
+
+private:
+    static inline size_t word(int x, int y) { return y * WORDS + x / 64; };
+
+    std::array<uint64_t, WORDS * height> m_words {};
+};
+
+template<size_t width, size_t height>
+constexpr size_t Bitboard<width, height>::WORDS;
+
+// Breadth-first searches over a passability bitboard, a frontier at a time.
+namespace bitbfs {
+
+// Calls visit(layer, rows, distance) for every BFS layer from start until
+// it returns false.
+template<size_t width, size_t height, typename Visitor>
+void grow(const Bitboard<width, height>& passable, const GridLocation& start, Visitor visit)
+{
+    using Board = Bitboard<width, height>;
+    std::unique_ptr<Board> frontier(new Board), next(new Board), visited(new Board);
+    frontier->set(start);
+    visited->set(start);
+    typename Board::Rows rows(std::get<1>(start), std::get<1>(start)), stale;
+    for (int distance = 0; !rows.empty() && visit(*frontier, rows, distance); distance++) {
+        next->clear_rows(stale);
+        stale = rows;
+        rows = frontier->advance(rows, passable, *visited, *next);
+        std::swap(frontier, next);
+    }
+}
+
+// Everything reachable from start, start included.
+template<size_t width, size_t height>
+Bitboard<width, height> flood(const Bitboard<width, height>& passable, const GridLocation& start)
+{
+    using Board = Bitboard<width, height>;
+    Board region;
+    grow(passable, start, [&region](const Board& layer, typename Board::Rows rows, int) {
+        region.merge(layer, rows);
+        return true;
+    });
+    return region;
+}
+
+template<size_t width, size_t height>
+bool reachable(const Bitboard<width, height>& passable, const GridLocation& start, const GridLocation& goal)
+{
+    using Board = Bitboard<width, height>;
+    bool found = false;
+    grow(passable, start, [&](const Board& layer, typename Board::Rows, int) {
+        found = layer.test(goal);
+        return !found;
+    });
+    return found;
+}
+
+// Steps from start to every tile, -1 where it can't be reached.
+template<size_t width, size_t height>
+void distance_field(const Bitboard<width, height>& passable, const GridLocation& start, std::vector<int>& distances)
+{
+    using Board = Bitboard<width, height>;
+    distances.assign(width * height, -1);
+    grow(passable, start, [&distances](const Board& layer, typename Board::Rows rows, int distance) {
+        layer.for_each([&](int x, int y) { distances[y * width + x] = distance; }, rows);
+        return true;
+    });
+}
+
+// Numbers the 4-connected passable regions from 1. Returns how many.
+template<size_t width, size_t height>
+uint32_t label_regions(const Bitboard<width, height>& passable, std::vector<uint32_t>& labels)
+{
+    labels.assign(width * height, 0);
+    uint32_t regions = 0;
+    passable.for_each([&](int x, int y) {
+        if (labels[y * width + x] == 0) {
+            regions++;
+            flood(passable, GridLocation(x, y)).for_each([&](int rx, int ry) {
+                labels[ry * width + rx] = regions;
+            });
+        }
+    });
+    return regions;
+}
+
+// A target in the nearest layer that has one. False if none is reachable.
+template<size_t width, size_t height>
+bool nearest_target(const Bitboard<width, height>& passable, const GridLocation& start,
+                    const Bitboard<width, height>& targets, GridLocation& target)
+{
+    using Board = Bitboard<width, height>;
+    bool found = false;
+    grow(passable, start, [&](const Board& layer, typename Board::Rows rows, int) {
+        found = layer.first_common(targets, rows, target);
+        return !found;
+    });
+    return found;
+}
+
+} // namespace bitbfs
+
+#endif // BITBOARD_H
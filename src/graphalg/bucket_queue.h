@@ -0,0 +1,137 @@
+#ifndef BUCKET_QUEUE_H
+#define BUCKET_QUEUE_H
+
+#include <cstdint>
+#include <vector>
+#include <assert.h>
+#include "search_workspace.h"
+
+// Dial-style bucket queue for small integer priorities over node indices.
+template<typename Number=int>
+class BucketQueue
+{
+public:
+    BucketQueue()
+        : m_buckets(64)
+        , m_size(0)
+        , m_cursor(0)
+        , m_top(0)
+        , m_generation(1) {};
+
+    inline bool empty() const { return m_size == 0; };
+
+    void clear() {
+        if (m_size) {
+            for (auto& bucket : m_buckets) {
+                bucket.clear();
+            }
+            m_size = 0;
+        }
+        m_generation++;
+        if (m_generation == 0) {
+            for (auto& slot : m_slots) {
+                slot.generation = 0;
+            }
+            m_generation = 1;
+        }
+    };
+
+    void put(NodeIndex item, Number priority) {
+        if (item >= m_slots.size()) {
+            m_slots.resize(std::max<size_t>(item + 1, m_slots.size() * 2));
+        }
+
+        Slot& slot = m_slots[item];
+        if (slot.generation == m_generation) {
+            if (priority >= slot.priority) {
+                return;
+            }
+            unlink(item);
+        }
+
+        if (m_size == 0) {
+            m_cursor = m_top = priority;
+        } else {
+            m_cursor = std::min(m_cursor, priority);
+            m_top = std::max(m_top, priority);
+            if (static_cast<size_t>(m_top - m_cursor) >= m_buckets.size()) {
+                grow(m_top - m_cursor);
+            }
+        }
+
+        link(item, priority);
+    };
+
+    Number top_priority() {
+        assert(m_size > 0);
+        const size_t mask = m_buckets.size() - 1;
+        while (m_buckets[m_cursor & mask].empty()) {
+            m_cursor++;
+        }
+        return m_cursor;
+    };
+
+    NodeIndex get() {
+        auto& bucket = m_buckets[top_priority() & (m_buckets.size() - 1)];
+        NodeIndex item = bucket.back();
+        bucket.pop_back();
+        m_slots[item].generation = 0;
+        m_size--;
+        return item;
+    };
+
+private:
+    struct Slot {
+        uint32_t generation;
+        uint32_t position;
+        Number priority;
+
+        Slot() : generation(0), position(0), priority(0) {};
+    };
+
+    inline void link(NodeIndex item, Number priority) {
+        auto& bucket = m_buckets[priority & (m_buckets.size() - 1)];
+        Slot& slot = m_slots[item];
+        slot.generation = m_generation;
+        slot.position = bucket.size();
+        slot.priority = priority;
+        bucket.push_back(item);
+        m_size++;
+    };
+
+    inline void unlink(NodeIndex item) {
+        const Slot& slot = m_slots[item];
+        auto& bucket = m_buckets[slot.priority & (m_buckets.size() - 1)];
+        NodeIndex last = bucket.back();
+        bucket[slot.position] = last;
+        m_slots[last].position = slot.position;
+        bucket.pop_back();
+        m_slots[item].generation = 0;
+        m_size--;
+    };
+
+    void grow(size_t span) {
+        size_t count = m_buckets.size();
+        while (count <= span) {
+            count *= 2;
+        }
+
+        std::vector<std::vector<NodeIndex> > old_buckets(count);
+        old_buckets.swap(m_buckets);
+        m_size = 0;
+        for (auto& bucket : old_buckets) {
+            for (auto item : bucket) {
+                link(item, m_slots[item].priority);
+            }
+        }
+    };
+
+    std::vector<std::vector<NodeIndex> > m_buckets; // size is a power of two
+    std::vector<Slot> m_slots;
+    size_t m_size;
+    Number m_cursor; // no queued priority is lower than this
+    Number m_top;    // no queued priority is higher than this
+    uint32_t m_generation;
+};
+
+#endif // BUCKET_QUEUE_H
@@ -0,0 +1,134 @@
+#ifndef COMPACT_PATH_H
+#define COMPACT_PATH_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include <assert.h>
+#include "gridlocation.h"
+
+// A path as its first tile and two-byte moves between waypoints. A move
+// of zero is a wait of one step.
+class CompactPath
+{
+public:
+    struct Move {
+        int8_t dx;
+        int8_t dy;
+
+        bool is_wait() const { return dx == 0 && dy == 0; };
+        // Straight or diagonal, i.e. made of single grid steps.
+        bool is_run() const { return dx == 0 || dy == 0 || std::abs(dx) == std::abs(dy); };
+    };
+
+    CompactPath() : m_start_x(0), m_start_y(0), m_end_x(0), m_end_y(0), m_empty(true) {};
+    explicit CompactPath(const GridLocation& start)
+        : m_start_x(std::get<0>(start))
+        , m_start_y(std::get<1>(start))
+        , m_end_x(m_start_x)
+        , m_end_y(m_start_y)
+        , m_empty(false) {};
+
+    // The same tile twice is a wait.
+    static CompactPath from_waypoints(const std::vector<GridLocation>& waypoints) {
+        if (waypoints.empty()) {
+            return CompactPath();
+        }
+        CompactPath path(waypoints.front());
+        for (size_t i = 1; i < waypoints.size(); i++) {
+            path.push(waypoints[i]);
+        }
+        return path;
+    };
+
+    // Moves too long for a byte are split.
+    void push(const GridLocation& loc) {
+        assert(!m_empty);
+        int dx = std::get<0>(loc) - m_end_x, dy = std::get<1>(loc) - m_end_y;
+        m_end_x = std::get<0>(loc);
+        m_end_y = std::get<1>(loc);
+        if (dx == 0 && dy == 0) {
+            m_moves.push_back(Move {0, 0});
+            return;
+        }
+
+        const int parts = (std::max(std::abs(dx), std::abs(dy)) + MAX_MOVE - 1) / MAX_MOVE;
+        for (int part = 0; part < parts; part++) {
+            // Rounded alike, the parts add up to the whole move.
+            Move move {static_cast<int8_t>(dx * (part + 1) / parts - dx * part / parts),
+                       static_cast<int8_t>(dy * (part + 1) / parts - dy * part / parts)};
+            if (!m_moves.empty() && continues(m_moves.back(), move)) {
+                m_moves.back().dx += move.dx;
+                m_moves.back().dy += move.dy;
+            } else {
+                m_moves.push_back(move);
+            }
+        }
+    };
+
+    bool empty() const { return m_empty; };
+    GridLocation start() const { return GridLocation(m_start_x, m_start_y); };
+    GridLocation end() const { return GridLocation(m_end_x, m_end_y); };
+    size_t moves() const { return m_moves.size(); };
+    const Move& move(size_t i) const { return m_moves[i]; };
+
+    // Calls visit(loc) for the start and every waypoint after it.
+    template<typename Visitor>
+    void for_each_waypoint(Visitor visit) const {
+        if (m_empty) {
+            return;
+        }
+        int x(m_start_x), y(m_start_y);
+        visit(GridLocation(x, y));
+        for (auto& move : m_moves) {
+            x += move.dx;
+            y += move.dy;
+            visit(GridLocation(x, y));
+        }
+    }
+
+    // Every tile along a grid path, one per step, as searches return it.
+    std::vector<GridLocation> steps() const {
+        std::vector<GridLocation> result;
+        if (m_empty) {
+            return result;
+        }
+        int x(m_start_x), y(m_start_y);
+        result.emplace_back(x, y);
+        for (auto& move : m_moves) {
+            assert(move.is_run());
+            const int length = std::max(std::abs(move.dx), std::abs(move.dy));
+            for (int step = 0; step < std::max(length, 1); step++) {
+                x += length ? move.dx / length : 0;
+                y += length ? move.dy / length : 0;
+                result.emplace_back(x, y);
+            }
+        }
+        return result;
+    };
+
+    // Memory the path takes, itself included.
+    size_t bytes() const { return sizeof(*this) + m_moves.capacity() * sizeof(Move); };
+
+private:
+    static const int MAX_MOVE = 127;
+
+    // Whether next carries on in the same direction as a grid run.
+    static bool continues(const Move& last, const Move& next) {
+        return !last.is_wait() && last.is_run() && next.is_run() &&
+               last.dx * next.dy == last.dy * next.dx &&
+               (last.dx > 0) == (next.dx > 0) && (last.dx < 0) == (next.dx < 0) &&
+               (last.dy > 0) == (next.dy > 0) && (last.dy < 0) == (next.dy < 0) &&
+               std::abs(last.dx + next.dx) <= MAX_MOVE && std::abs(last.dy + next.dy) <= MAX_MOVE;
+    };
+
+    int16_t m_start_x;
+    int16_t m_start_y;
+    int16_t m_end_x;
+    int16_t m_end_y;
+    bool m_empty;
+    std::vector<Move> m_moves;
+};
+
+#endif // COMPACT_PATH_H
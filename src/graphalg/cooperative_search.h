@@ -0,0 +1,151 @@
+#ifndef COOPERATIVE_SEARCH_H
+#define COOPERATIVE_SEARCH_H
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include "search_workspace.h"
+
+// Which agent will stand on which node at which time step.
+template<typename Agent>
+class ReservationTable
+{
+public:
+    // Another agent than agent is on idx at time.
+    bool blocked(NodeIndex idx, uint32_t time, Agent agent) const {
+        auto owner = m_owners.find(key(idx, time));
+        return owner != m_owners.end() && owner->second != agent;
+    };
+
+    // Nobody else is on idx at any time from from_time to until_time.
+    bool free(NodeIndex idx, uint32_t from_time, uint32_t until_time, Agent agent) const {
+        for (uint32_t time = from_time; time <= until_time; time++) {
+            if (blocked(idx, time, agent)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Moving from a to b at time would swap places with another agent.
+    bool swaps(NodeIndex a, NodeIndex b, uint32_t time, Agent agent) const {
+        auto towards_a = m_owners.find(key(a, time + 1));
+        if (towards_a == m_owners.end() || towards_a->second == agent) {
+            return false;
+        }
+        auto from_b = m_owners.find(key(b, time));
+        return from_b != m_owners.end() && from_b->second == towards_a->second;
+    };
+
+    // One node per time step from start_time, the last until until_time.
+    void reserve(const std::vector<NodeIndex>& path, uint32_t start_time, uint32_t until_time, Agent agent) {
+        auto& keys = m_keys[agent];
+        for (uint32_t time = start_time; !path.empty() && time <= until_time; time++) {
+            size_t step = std::min<size_t>(time - start_time, path.size() - 1);
+            uint64_t reserved = key(path[step], time);
+            m_owners[reserved] = agent;
+            keys.push_back(reserved);
+        }
+    };
+
+    void release(Agent agent) {
+        auto keys = m_keys.find(agent);
+        if (keys == m_keys.end()) {
+            return;
+        }
+        for (auto reserved : keys->second) {
+            auto owner = m_owners.find(reserved);
+            if (owner != m_owners.end() && owner->second == agent) {
+                m_owners.erase(owner);
+            }
+        }
+        m_keys.erase(keys);
+    };
+
+private:
+    static inline uint64_t key(NodeIndex idx, uint32_t time) {
+        return static_cast<uint64_t>(time) << 32 | idx;
+    };
+
+    std::unordered_map<uint64_t, Agent> m_owners;
+    std::unordered_map<Agent, std::vector<uint64_t> > m_keys;
+};
+
+// Windowed Hierarchical Cooperative A* (WHCA*): a node per time step, for
+// window steps of straight moves and waits. Empty if the agent is boxed in.
+template<typename Graph, typename Workspace, typename Heuristic, typename Agent>
+std::vector<NodeIndex> cooperative_search(const Graph &graph,
+                                          typename Graph::Node start,
+                                          typename Graph::Node goal,
+                                          uint32_t start_time,
+                                          uint32_t window,
+                                          Heuristic heuristic,
+                                          const ReservationTable<Agent> &reservations,
+                                          Agent agent,
+                                          Workspace &workspace)
+{
+    const NodeIndex size = graph.size();
+    const NodeIndex start_idx = graph.index(start);
+    const NodeIndex goal_idx = graph.index(goal);
+    auto &frontier = workspace.frontier;
+
+    // State dt * size + idx: at node idx dt steps after start_time.
+    workspace.reset(size * (window + 1));
+    workspace.relax(start_idx, 0, start_idx);
+    frontier.put(start_idx, heuristic(start, goal));
+
+    std::vector<NodeIndex> path;
+    bool found = false;
+    NodeIndex state = start_idx;
+    while (!frontier.empty()) {
+        state = frontier.get();
+        workspace.stats.popped();
+        const NodeIndex idx = state % size;
+        const uint32_t dt = state / size;
+        // Only stop at the goal if nobody passes through it later.
+        if ((idx == goal_idx && reservations.free(idx, start_time + dt, start_time + window, agent)) ||
+                dt == window) {
+            found = true;
+            break;
+        }
+
+        workspace.stats.expanded();
+        auto current_loc = graph.location(idx);
+        const uint32_t time = start_time + dt;
+        auto visit = [&](const typename Graph::Node& next) {
+            if (std::get<0>(next) != std::get<0>(current_loc) && std::get<1>(next) != std::get<1>(current_loc)) {
+                return; // a diagonal takes longer than a time step to walk
+            }
+            NodeIndex next_idx = graph.index(next);
+            if (reservations.blocked(next_idx, time + 1, agent) ||
+                    reservations.swaps(idx, next_idx, time, agent)) {
+                return;
+            }
+            NodeIndex next_state = (dt + 1) * size + next_idx;
+            int new_cost = workspace.cost(state) + graph.cost(current_loc, next); // waiting costs a straight step
+            const bool reached = workspace.reached(next_state);
+            if (!reached || new_cost < workspace.cost(next_state)) {
+                workspace.relax(next_state, new_cost, state);
+                frontier.put(next_state, new_cost + heuristic(next, goal));
+                workspace.stats.pushed(reached);
+            }
+        };
+        graph.for_each_neighbor(current_loc, visit);
+        visit(current_loc); // wait
+    }
+
+    if (!found) {
+        workspace.stats.end(0);
+        return path;
+    }
+    for (; state >= size; state = workspace.came_from(state)) {
+        path.push_back(state % size);
+    }
+    path.push_back(start_idx);
+    std::reverse(path.begin(), path.end());
+    workspace.stats.end(path.size());
+    return path;
+}
+
+#endif // COOPERATIVE_SEARCH_H
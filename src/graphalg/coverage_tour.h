@@ -0,0 +1,161 @@
+#ifndef COVERAGE_TOUR_H
+#define COVERAGE_TOUR_H
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "gridlocation.h"
+
+namespace coverage {
+
+// A vertical run of tiles to cover in column x.
+struct Segment {
+    int x;
+    int top;
+    int bottom;
+};
+
+inline bool overlap(const Segment& a, const Segment& b)
+{
+    return a.top <= b.bottom && b.top <= a.bottom;
+}
+
+// Boustrophedon decomposition into cells of column segments, left to right.
+inline std::vector<std::vector<Segment> > decompose(std::vector<GridLocation> tiles)
+{
+    std::sort(tiles.begin(), tiles.end());
+    std::vector<Segment> segments;
+    for (auto& tile : tiles) {
+        int x, y;
+        std::tie(x, y) = tile;
+        if (!segments.empty() && segments.back().x == x && segments.back().bottom + 1 == y) {
+            segments.back().bottom = y;
+        } else {
+            segments.push_back(Segment {x, y, y});
+        }
+    }
+
+    std::vector<std::vector<Segment> > cells;
+    std::vector<size_t> cell_of(segments.size());
+    size_t column = 0, previous = 0;
+    while (column < segments.size()) {
+        size_t next = column;
+        while (next < segments.size() && segments[next].x == segments[column].x) {
+            next++;
+        }
+        const bool adjacent = previous < column && segments[previous].x + 1 == segments[column].x;
+        for (size_t s = column; s < next; s++) {
+            size_t joined = 0, left = 0;
+            for (size_t p = previous; adjacent && p < column; p++) {
+                if (overlap(segments[p], segments[s])) {
+                    joined = p;
+                    left++;
+                }
+            }
+            size_t right = 0;
+            for (size_t t = column; left == 1 && t < next; t++) {
+                right += overlap(segments[joined], segments[t]) ? 1 : 0;
+            }
+            if (left == 1 && right == 1) {
+                cell_of[s] = cell_of[joined];
+            } else {
+                cell_of[s] = cells.size();
+                cells.emplace_back();
+            }
+            cells[cell_of[s]].push_back(segments[s]);
+        }
+        previous = column;
+        column = next;
+    }
+    return cells;
+}
+
+} // namespace coverage
+
+// Cells still to sweep: go to the nearest of entries(), then sweep() it.
+class CoveragePlan
+{
+public:
+    // Tiles has to hold passable tiles only.
+    explicit CoveragePlan(const std::vector<GridLocation>& tiles)
+        : m_cells(coverage::decompose(tiles))
+    {
+        for (size_t cell = 0; cell < m_cells.size(); cell++) {
+            auto& first = m_cells[cell].front();
+            auto& last = m_cells[cell].back();
+            for (int y : {first.top, first.bottom}) {
+                m_entries.emplace(GridLocation(first.x, y), Entry {cell, false});
+            }
+            for (int y : {last.top, last.bottom}) {
+                m_entries.emplace(GridLocation(last.x, y), Entry {cell, true});
+            }
+        }
+    };
+
+    bool done() const { return m_entries.empty(); };
+    bool is_entry(const GridLocation& loc) const { return m_entries.count(loc) > 0; };
+    // The ends of the first and last columns of cells still to do.
+    std::unordered_set<GridLocation> entries() const {
+        std::unordered_set<GridLocation> entries;
+        for (auto& entry : m_entries) {
+            entries.insert(entry.first);
+        }
+        return entries;
+    };
+
+    // The walk over the cell entry leads into, which is done after that.
+    std::vector<GridLocation> sweep(const GridLocation& entry) {
+        const Entry found = m_entries.at(entry);
+        auto& segments = m_cells[found.cell];
+        if (found.reversed) {
+            std::reverse(segments.begin(), segments.end());
+        }
+
+        std::vector<GridLocation> path {entry};
+        auto walk_to = [&path](int x, int y) {
+            int from_x, from_y;
+            std::tie(from_x, from_y) = path.back();
+            for (; from_x != x; path.push_back(GridLocation(from_x, from_y))) {
+                from_x += from_x < x ? 1 : -1;
+            }
+            for (; from_y != y; path.push_back(GridLocation(from_x, from_y))) {
+                from_y += from_y < y ? 1 : -1;
+            }
+        };
+        for (size_t s = 0; s < segments.size(); s++) {
+            auto& segment = segments[s];
+            int y = std::get<1>(path.back());
+            if (s > 0) {
+                // Cross over where this segment and the last one overlap.
+                auto& last = segments[s - 1];
+                y = std::min(std::max(y, std::max(segment.top, last.top)), std::min(segment.bottom, last.bottom));
+                walk_to(last.x, y);
+                walk_to(segment.x, y);
+            }
+            if (y - segment.top <= segment.bottom - y) {
+                walk_to(segment.x, segment.top);
+                walk_to(segment.x, segment.bottom);
+            } else {
+                walk_to(segment.x, segment.bottom);
+                walk_to(segment.x, segment.top);
+            }
+        }
+
+        for (auto it = m_entries.begin(); it != m_entries.end(); ) {
+            it = it->second.cell == found.cell ? m_entries.erase(it) : std::next(it);
+        }
+        return path;
+    };
+
+private:
+    struct Entry {
+        size_t cell;
+        bool reversed;
+    };
+
+    std::vector<std::vector<coverage::Segment> > m_cells;
+    std::unordered_map<GridLocation, Entry> m_entries;
+};
+
+#endif // COVERAGE_TOUR_H
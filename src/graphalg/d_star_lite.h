@@ -0,0 +1,216 @@
+#ifndef D_STAR_LITE_H
+#define D_STAR_LITE_H
+
+#include <cstdint>
+#include <climits>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "gridlocation.h"
+#include "search_workspace.h"
+
+// D* Lite planner towards a fixed goal on a GridGraph.
+template<typename Graph, typename Recorder = SearchRecorder<> >
+class DStarLite
+{
+public:
+    using Node = typename Graph::Node;
+
+    DStarLite(const Graph& graph, Node goal)
+        : m_graph(graph)
+        , m_heuristic()
+        , m_queued_key(Graph::size())
+    {
+        reset(goal);
+    };
+
+    // Plans towards another goal from scratch, in the same arrays.
+    void reset(Node goal) {
+        m_goal = goal;
+        m_start = goal;
+        m_km = 0;
+        m_g.assign(Graph::size(), INF);
+        m_rhs.assign(Graph::size(), INF);
+        m_queued.assign(Graph::size(), false);
+        m_queue.clear();
+        const NodeIndex goal_idx = m_graph.index(goal);
+        m_rhs[goal_idx] = 0;
+        push(goal_idx);
+    };
+
+    Node goal() const { return m_goal; };
+
+    // Shortest path from start to the goal, empty if there is none.
+    std::vector<Node> find_path(Node start) {
+        m_stats.begin();
+        std::vector<Node> path;
+        if (start != m_start) {
+            // Keeps the keys queued for the old start lower bounds.
+            m_km += m_heuristic(m_start, start);
+            m_start = start;
+        }
+        compute_shortest_path();
+
+        NodeIndex current = m_graph.index(start);
+        if (m_g[current] >= INF) {
+            m_stats.end(0);
+            return path;
+        }
+        const NodeIndex goal_idx = m_graph.index(m_goal);
+        path.push_back(start);
+        while (current != goal_idx) {
+            NodeIndex best = current;
+            int best_cost = INF;
+            for_each_adjacent(current, [&](NodeIndex next) {
+                int cost = add(edge_cost(current, next), m_g[next]);
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best = next;
+                }
+            });
+            if (best == current || path.size() > Graph::size()) {
+                path.clear();
+                break;
+            }
+            current = best;
+            path.push_back(m_graph.location(current));
+        }
+        m_stats.end(path.size());
+        return path;
+    };
+
+    // What the last find_path() did, repairs included.
+    SearchStats stats() const { return m_stats.stats(); };
+
+    // Call after the passability of loc has changed.
+    void notify_changed(Node loc) {
+        const NodeIndex idx = m_graph.index(loc);
+        update_vertex(idx);
+        for_each_adjacent(idx, [this](NodeIndex next) { update_vertex(next); });
+    };
+
+private:
+    static const int INF = INT_MAX / 4;
+
+    using Key = std::pair<int, int>;
+    using QueueEntry = std::pair<Key, NodeIndex>;
+
+    static inline int add(int a, int b) { return std::min(INF, a + b); };
+
+    // Passable or not, unlike the graph's neighbours, as edges come and go.
+    template<typename Visitor>
+    inline void for_each_adjacent(NodeIndex idx, Visitor visit) const {
+        const Node loc = m_graph.location(idx);
+        for (int dir = 0; dir < Graph::CONNECTIVITY; dir++) {
+            Node next = Graph::step(loc, dir);
+            if (m_graph.in_bounds(next)) {
+                visit(m_graph.index(next));
+            }
+        }
+    }
+
+    inline int edge_cost(NodeIndex a, NodeIndex b) const {
+        Node from = m_graph.location(a), to = m_graph.location(b);
+        if (!m_graph.passable(from) || !m_graph.passable(to)) {
+            return INF;
+        }
+        int x1, y1, x2, y2;
+        std::tie(x1, y1) = from;
+        std::tie(x2, y2) = to;
+        if (x1 != x2 && y1 != y2 && (!m_graph.passable(Node(x2, y1)) || !m_graph.passable(Node(x1, y2)))) {
+            return INF; // cuts a corner
+        }
+        return m_graph.cost(from, to);
+    };
+
+    inline Key key(NodeIndex idx) const {
+        int value = std::min(m_g[idx], m_rhs[idx]);
+        return Key(add(add(value, m_heuristic(m_start, m_graph.location(idx))), m_km), value);
+    };
+
+    // A duplicate leaves an older entry of the node stale.
+    void push(NodeIndex idx, bool duplicate = false) {
+        m_stats.pushed(duplicate);
+        m_queued[idx] = true;
+        m_queued_key[idx] = key(idx);
+        m_queue.emplace_back(m_queued_key[idx], idx);
+        std::push_heap(m_queue.begin(), m_queue.end(), std::greater<QueueEntry>());
+    };
+
+    // Drops entries whose node was dequeued or re-keyed since.
+    void discard_stale() {
+        while (!m_queue.empty()) {
+            const QueueEntry& top = m_queue.front();
+            if (m_queued[top.second] && m_queued_key[top.second] == top.first) {
+                break;
+            }
+            std::pop_heap(m_queue.begin(), m_queue.end(), std::greater<QueueEntry>());
+            m_queue.pop_back();
+            m_stats.popped();
+        }
+    };
+
+    void update_vertex(NodeIndex idx) {
+        if (idx != m_graph.index(m_goal)) {
+            int best = INF;
+            if (m_graph.passable(m_graph.location(idx))) {
+                for_each_adjacent(idx, [&](NodeIndex next) {
+                    best = std::min(best, add(edge_cost(idx, next), m_g[next]));
+                });
+            }
+            m_rhs[idx] = best;
+        }
+        const bool queued = m_queued[idx];
+        m_queued[idx] = false;
+        if (m_g[idx] != m_rhs[idx]) {
+            push(idx, queued);
+        }
+    };
+
+    void compute_shortest_path() {
+        const NodeIndex start_idx = m_graph.index(m_start);
+        discard_stale();
+        while (!m_queue.empty() &&
+               (m_queue.front().first < key(start_idx) || m_rhs[start_idx] != m_g[start_idx])) {
+            const Key old_key = m_queue.front().first;
+            const NodeIndex idx = m_queue.front().second;
+            const Key new_key = key(idx);
+            std::pop_heap(m_queue.begin(), m_queue.end(), std::greater<QueueEntry>());
+            m_queue.pop_back();
+            m_queued[idx] = false;
+            m_stats.popped();
+
+            if (old_key < new_key) {
+                push(idx);
+                continue;
+            }
+            m_stats.expanded();
+            if (m_g[idx] > m_rhs[idx]) {
+                m_g[idx] = m_rhs[idx];
+                for_each_adjacent(idx, [this](NodeIndex next) { update_vertex(next); });
+            } else {
+                m_g[idx] = INF;
+                update_vertex(idx);
+                for_each_adjacent(idx, [this](NodeIndex next) { update_vertex(next); });
+            }
+            discard_stale();
+        }
+    };
+
+    const Graph& m_graph;
+    const typename Graph::Heuristic m_heuristic;
+    Node m_goal;
+    Node m_start;
+    int m_km;
+    std::vector<int> m_g;
+    std::vector<int> m_rhs;
+    std::vector<bool> m_queued;
+    std::vector<Key> m_queued_key;
+    std::vector<QueueEntry> m_queue; // min-heap, may hold stale entries
+    Recorder m_stats;
+};
+
+template<typename Graph, typename Recorder>
+const int DStarLite<Graph, Recorder>::INF;
+
+#endif // D_STAR_LITE_H
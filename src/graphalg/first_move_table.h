@@ -0,0 +1,186 @@
+#ifndef FIRST_MOVE_TABLE_H
+#define FIRST_MOVE_TABLE_H
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include "gridlocation.h"
+#include "search_workspace.h"
+#include "bucket_queue.h"
+#include "a_star_search.h"
+
+// First moves of shortest paths between all pairs of tiles, stored per
+// source as runs over the targets along a Hilbert curve.
+template<typename Graph>
+class FirstMoveTable
+{
+public:
+    using Node = typename Graph::Node;
+
+    static const uint8_t NO_MOVE = 8;
+
+    FirstMoveTable() : m_graph(nullptr) {};
+
+    bool built() const { return m_graph != nullptr; };
+    size_t run_count() const { return m_runs.size(); };
+
+    // Has to be called again whenever the graph's passability changes.
+    void build(const Graph& graph, unsigned threads = 0) {
+        const size_t size = Graph::size();
+        m_graph = &graph;
+
+        size_t side = 1;
+        while (side < std::max(Graph::grid_width(), Graph::grid_height())) {
+            side *= 2;
+        }
+        m_curve_pos.resize(size);
+        m_by_curve_pos.resize(size);
+        for (NodeIndex idx = 0; idx < size; idx++) {
+            int x, y;
+            std::tie(x, y) = graph.location(idx);
+            m_curve_pos[idx] = hilbert_index(side, x, y);
+            m_by_curve_pos[idx] = idx;
+        }
+        std::sort(m_by_curve_pos.begin(), m_by_curve_pos.end(),
+                  [this](NodeIndex a, NodeIndex b) { return m_curve_pos[a] < m_curve_pos[b]; });
+
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        std::vector<std::vector<uint32_t> > rows(size);
+        std::vector<std::thread> workers;
+        for (unsigned worker = 0; worker < threads; worker++) {
+            workers.emplace_back([this, &rows, worker, threads, size]() {
+                SearchWorkspace<int, BucketQueue<int> > workspace;
+                std::vector<NodeIndex> settled;
+                std::vector<uint8_t> first_moves(size, NO_MOVE);
+                for (NodeIndex source = worker; source < size; source += threads) {
+                    if (m_graph->passable(m_graph->location(source))) {
+                        build_row(source, workspace, settled, first_moves, rows[source]);
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        m_runs.clear();
+        m_offsets.assign(1, 0);
+        for (auto& row : rows) {
+            m_runs.insert(m_runs.end(), row.begin(), row.end());
+            m_offsets.push_back(m_runs.size());
+        }
+    };
+
+    // GridGraph::step() direction from start towards goal, or NO_MOVE.
+    uint8_t first_move(Node start, Node goal) const {
+        const NodeIndex start_idx = m_graph->index(start);
+        const NodeIndex goal_idx = m_graph->index(goal);
+        if (start_idx == goal_idx) {
+            return NO_MOVE;
+        }
+        auto begin = m_runs.begin() + m_offsets[start_idx];
+        auto end = m_runs.begin() + m_offsets[start_idx + 1];
+        auto run = std::upper_bound(begin, end, (m_curve_pos[goal_idx] << MOVE_BITS) | MOVE_MASK);
+        if (run == begin) {
+            return NO_MOVE;
+        }
+        return *(run - 1) & MOVE_MASK;
+    };
+
+    // Empty if the table can't lead from start to goal.
+    std::vector<Node> find_path(Node start, Node goal) const {
+        std::vector<Node> path {start};
+        auto current = start;
+        while (current != goal) {
+            auto move = first_move(current, goal);
+            if (move == NO_MOVE || path.size() > Graph::size()) {
+                path.clear();
+                break;
+            }
+            current = Graph::step(current, move);
+            path.push_back(current);
+        }
+        return path;
+    };
+
+private:
+    static const int MOVE_BITS = 3;
+    static const uint32_t MOVE_MASK = (1 << MOVE_BITS) - 1;
+
+    void build_row(NodeIndex source,
+                   SearchWorkspace<int, BucketQueue<int> >& workspace,
+                   std::vector<NodeIndex>& settled,
+                   std::vector<uint8_t>& first_moves,
+                   std::vector<uint32_t>& row) const {
+        settled.clear();
+        dijkstra(*m_graph, {source}, workspace, [&settled](NodeIndex current) {
+            settled.push_back(current);
+            return true;
+        });
+
+        // Parents are settled before their children.
+        int sx, sy;
+        std::tie(sx, sy) = m_graph->location(source);
+        for (auto idx : settled) {
+            auto parent = workspace.came_from(idx);
+            if (idx == source) {
+                first_moves[idx] = NO_MOVE;
+            } else if (parent == source) {
+                int x, y;
+                std::tie(x, y) = m_graph->location(idx);
+                first_moves[idx] = Graph::direction(x - sx, y - sy);
+            } else {
+                first_moves[idx] = first_moves[parent];
+            }
+        }
+
+        row.clear();
+        for (auto idx : m_by_curve_pos) {
+            if (!workspace.reached(idx) || idx == source) {
+                continue; // don't care
+            }
+            if (row.empty() || (row.back() & MOVE_MASK) != first_moves[idx]) {
+                row.push_back((m_curve_pos[idx] << MOVE_BITS) | first_moves[idx]);
+            }
+        }
+        row.shrink_to_fit();
+    };
+
+    // Position of (x, y) along a Hilbert curve filling a side x side square.
+    static uint32_t hilbert_index(uint32_t side, uint32_t x, uint32_t y) {
+        uint32_t d = 0;
+        for (uint32_t s = side / 2; s > 0; s /= 2) {
+            uint32_t rx = (x & s) > 0;
+            uint32_t ry = (y & s) > 0;
+            d += s * s * ((3 * rx) ^ ry);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = side - 1 - x;
+                    y = side - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    };
+
+    const Graph* m_graph;
+    std::vector<uint32_t> m_curve_pos;     // node index -> curve position
+    std::vector<NodeIndex> m_by_curve_pos; // node indices along the curve
+    std::vector<uint32_t> m_runs;          // curve position << MOVE_BITS | direction
+    std::vector<size_t> m_offsets;         // first run of every source
+};
+
+template<typename Graph>
+const uint8_t FirstMoveTable<Graph>::NO_MOVE;
+
+template<typename Graph>
+const int FirstMoveTable<Graph>::MOVE_BITS;
+
+template<typename Graph>
+const uint32_t FirstMoveTable<Graph>::MOVE_MASK;
+
+#endif // FIRST_MOVE_TABLE_H
@@ -0,0 +1,113 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include "gridlocation.h"
+#include "search_workspace.h"
+#include "bucket_queue.h"
+#include "a_star_search.h"
+
+// Directions towards a single goal from every tile that can reach it.
+template<typename Graph>
+class FlowField
+{
+public:
+    using Node = typename Graph::Node;
+
+    FlowField() : m_graph(nullptr), m_goal(0, 0) {};
+
+    bool built() const { return m_graph != nullptr; };
+    Node goal() const { return m_goal; };
+
+    // Has to be called again whenever the graph's passability changes.
+    void build(const Graph& graph, Node goal) {
+        m_graph = &graph;
+        m_goal = goal;
+        m_workspace.reset(Graph::size());
+        if (!graph.passable(goal)) {
+            return;
+        }
+
+        // Every tile's parent in the search is its next step to the goal.
+        dijkstra(graph, {graph.index(goal)}, m_workspace);
+    };
+
+    // Whether the goal can be reached from loc.
+    bool reaches(Node loc) const {
+        return built() && m_workspace.reached(m_graph->index(loc));
+    };
+
+    // The tile to step to from loc, loc itself at the goal.
+    Node next_step(Node loc) const { return m_graph->location(m_workspace.came_from(m_graph->index(loc))); };
+
+    // Empty if the goal can't be reached from start.
+    std::vector<Node> find_path(Node start) const {
+        std::vector<Node> path;
+        if (!reaches(start)) {
+            return path;
+        }
+        path.push_back(start);
+        for (auto current = start; current != m_goal; path.push_back(current)) {
+            current = next_step(current);
+        }
+        return path;
+    };
+
+private:
+    const Graph* m_graph;
+    Node m_goal;
+    SearchWorkspace<int, BucketQueue<int> > m_workspace;
+};
+
+// Which goal each agent is heading for.
+template<typename Agent>
+class SharedGoals
+{
+public:
+    // Returns how many agents head for goal.
+    size_t assign(Agent agent, const GridLocation& goal) {
+        auto current = m_goals.find(agent);
+        if (current != m_goals.end()) {
+            if (current->second == goal) {
+                return m_agents[goal];
+            }
+            release(agent);
+        }
+        m_goals[agent] = goal;
+        return ++m_agents[goal];
+    };
+
+    // The agent's order is over.
+    void release(Agent agent) {
+        auto current = m_goals.find(agent);
+        if (current == m_goals.end()) {
+            return;
+        }
+        auto agents = m_agents.find(current->second);
+        if (--agents->second == 0) {
+            m_agents.erase(agents);
+        }
+        m_goals.erase(current);
+    };
+
+    // Calls visit(agent, goal) for every agent with an order.
+    template<typename Visitor>
+    void for_each(Visitor visit) const {
+        for (auto& goal : m_goals) {
+            visit(goal.first, goal.second);
+        }
+    }
+
+    size_t agents(const GridLocation& goal) const {
+        auto found = m_agents.find(goal);
+        return found != m_agents.end() ? found->second : 0;
+    };
+
+private:
+    std::unordered_map<Agent, GridLocation> m_goals;
+    std::unordered_map<GridLocation, size_t> m_agents;
+};
+
+#endif // FLOW_FIELD_H
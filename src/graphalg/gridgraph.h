@@ -4,23 +4,41 @@
 #include <fstream>      // for std::ifstream
 #include <sstream>      // for std::istringstream
 #include <array>
+#include <functional>
+#include <memory>
 #include <vector>
-#include <algorithm>    // for std::reverse
 #include <unordered_set>
+#include <type_traits>
 #include <assert.h>
 #include "gridlocation.h"
+#include "search_workspace.h"
+#include "heuristics.h"
+#include "bitboard.h"
 
-template <typename Node_T, size_t width, size_t height>
+// 4- or 8-connected grid; diagonals cost 14 against 10 and don't cut corners.
+template <typename Node_T, size_t width, size_t height, int connectivity = 4>
 class GridGraph
 {
 public:
     using Node = GridLocation;
+    using Heuristic = typename std::conditional<connectivity == 8,
+                                                OctileHeuristic<10, 14>,
+                                                ManhattanHeuristic<> >::type;
+
+    static_assert(connectivity == 4 || connectivity == 8, "grids are 4- or 8-connected");
+    static constexpr int CONNECTIVITY = connectivity;
+    static constexpr int STRAIGHT_COST = connectivity == 8 ? 10 : 1;
+    static constexpr int DIAGONAL_COST = 14;
 
     void load(std::string mapfile_path,
               std::function<std::unique_ptr<Node_T>(std::string)> get_node_instance) {
         std::ifstream mapFile(mapfile_path);
+        load(mapFile, get_node_instance);
+    };
+
+    void load(std::istream& mapFile,
+              std::function<std::unique_ptr<Node_T>(std::string)> get_node_instance) {
         std::string line;
-        std::unordered_set<GridLocation> locs;
 
         size_t row(0), node_idx(0);
         while (std::getline(mapFile, line)) {
@@ -31,165 +49,182 @@ public:
             while (std::getline(iss, token, ' ')) {
                 assert(column < width);
                 m_grid.at(node_idx) = get_node_instance(token);
-                locs.insert(GridLocation(column, row));
+                update_walkable(node_idx);
                 column++;
                 node_idx++;
             }
             row++;
         }
 
-        split_regions(locs);
+        assign_regions();
     };
 
-    Node_T* at(int x, int y) const { return m_grid.at(y * height + x).get(); };
+    Node_T* at(int x, int y) const { return m_grid.at(y * width + x).get(); };
 
-    std::vector<GridLocation> neighbors(GridLocation loc) const {
-        int x, y, dx, dy;
-        std::tie(x, y) = loc;
-        std::vector<GridLocation> results;
-        for (auto direction : DIRS) {
-            std::tie(dx, dy) = direction;
-            GridLocation next(x + dx, y + dy);
-            if (in_bounds(next) && passable(next)) {
-                results.push_back(next);
-            }
-        }
-
-        if ((x + y) % 2 == 0) {
-            // aesthetic improvement on square grids
-            std::reverse(results.begin(), results.end());
-        }
+    // Regions are recomputed for the whole grid.
+    void replace(int x, int y, std::unique_ptr<Node_T> node) {
+        m_grid.at(y * width + x) = std::move(node);
+        update_walkable(y * width + x);
+        assign_regions();
+    };
 
-        return results;
+    // Dense node numbering used by the searches' flat workspaces.
+    static constexpr size_t size() { return width * height; };
+    static constexpr size_t grid_width() { return width; };
+    static constexpr size_t grid_height() { return height; };
+    inline NodeIndex index(GridLocation loc) const {
+        return std::get<1>(loc) * width + std::get<0>(loc);
+    };
+    inline GridLocation location(NodeIndex idx) const {
+        return GridLocation(idx % width, idx / width);
     };
-    // This is for future references in case I want
-    // to implemenent different movement costs.
-    inline int cost(GridLocation a, GridLocation b) const { return 1; };
 
-    GridLocation closest(const GridLocation& current, const std::unordered_set<GridLocation>& locs) const {
+    // Right, up, left, down, then the diagonals between them.
+    static GridLocation step(const GridLocation& loc, int dir) {
+        return GridLocation(std::get<0>(loc) + DX[dir], std::get<1>(loc) + DY[dir]);
+    };
 
-        for (auto loc : neighbors(current)) {
-            if (locs.count(loc)) {
-                return loc;
+    // The move by (dx, dy), -1 if there is none.
+    static int direction(int dx, int dy) {
+        for (int dir = 0; dir < connectivity; dir++) {
+            if (DX[dir] == dx && DY[dir] == dy) {
+                return dir;
             }
         }
+        return -1;
+    };
 
-        std::vector<GridLocation> loc_vector;
-        for (auto loc : locs) {
-            loc_vector.push_back(loc);
+    // Calls visit(next) for every neighbour loc can move to.
+    template<typename Visitor>
+    inline void for_each_neighbor(const GridLocation& loc, Visitor visit) const {
+        int x, y;
+        std::tie(x, y) = loc;
+        const uint8_t* cell = &m_walkable[padded_index(x, y)];
+        for (int dir = 0; dir < 4; dir++) {
+            if (cell[PADDED_OFFSETS[dir]]) {
+                visit(GridLocation(x + DX[dir], y + DY[dir]));
+            }
         }
-        std::sort(loc_vector.begin(), loc_vector.end(),
-                 [current](const GridLocation& loc1, const GridLocation& loc2) {
-            return grid_distance(current, loc1) < grid_distance(current, loc2);
-        });
-
-        return *loc_vector.begin();
-    };
+        for (int dir = 4; dir < connectivity; dir++) {
+            if (cell[PADDED_OFFSETS[dir]] && cell[PADDED_OFFSETS[dir - 4]] && cell[PADDED_OFFSETS[(dir - 3) % 4]]) {
+                visit(GridLocation(x + DX[dir], y + DY[dir]));
+            }
+        }
+    }
+
+    // Same by node index.
+    template<typename Visitor>
+    inline void for_each_neighbor(NodeIndex idx, Visitor visit) const {
+        const uint8_t* cell = &m_walkable[idx + 2 * (idx / width) + width + 3];
+        for (int dir = 0; dir < 4; dir++) {
+            if (cell[PADDED_OFFSETS[dir]]) {
+                visit(idx + OFFSETS[dir]);
+            }
+        }
+        for (int dir = 4; dir < connectivity; dir++) {
+            if (cell[PADDED_OFFSETS[dir]] && cell[PADDED_OFFSETS[dir - 4]] && cell[PADDED_OFFSETS[(dir - 3) % 4]]) {
+                visit(idx + OFFSETS[dir]);
+            }
+        }
+    }
 
-private:
     inline bool in_bounds(GridLocation loc) const {
         int x, y;
         std::tie(x, y) = loc;
-        return x >= 0 && x < width && y >= 0 && y < height;
+        return x >= 0 && x < static_cast<int>(width) && y >= 0 && y < static_cast<int>(height);
     };
 
+    // Also false, rather than out of range, one step outside the grid.
     inline bool passable(GridLocation loc) const {
         int x, y;
         std::tie(x, y) = loc;
-        return m_grid.at(y * height + x)->passable();
+        return m_walkable[padded_index(x, y)];
     };
 
-    void split_regions(std::unordered_set<GridLocation>& locs) {
-        uint32_t reg(0);
-        while (!locs.empty()) {
-            reg++;
-            auto it = locs.begin();
-            // TODO: flood fill here
-            int32_t x, y;
-            std::tie(x, y) = *it;
-            auto first_node = m_grid.at(y * height + x).get();
-            first_node->set_region(reg);
-            flood_fill(x, y, locs, first_node);
-        }
-    };
-
-    void flood_fill(int32_t x, int32_t y, std::unordered_set<GridLocation>& locs, Node_T* first_node) {
-        auto reg(first_node->region());
+    // Passability one bit per tile, for the searches in bitbfs.
+    const Bitboard<width, height>& passable_bits() const { return m_passable_bits; };
 
-        if (!m_grid.at(y * height + x)->is_same_type(*first_node)) {
-            return;
-        }
+    // For neighbours, or a tile and itself.
+    inline int cost(GridLocation a, GridLocation b) const {
+        const int step = std::get<0>(a) != std::get<0>(b) && std::get<1>(a) != std::get<1>(b) ? DIAGONAL_COST : STRAIGHT_COST;
+        return step * (m_costs[index(a)] + m_costs[index(b)]) / 2;
+    };
 
-        int32_t x1(x);
+    // The tile's terrain cost, 0 if impassable.
+    inline int move_cost(GridLocation loc) const { return m_costs[index(loc)]; };
 
-        // scan current line from start to the right end
-        while (x1 < width && m_grid.at(y * height + x1)->is_same_type(*first_node)) {
-            m_grid.at(y * height + x1)->set_region(reg);
+    // Whether every passable tile costs 1, as e.g. jump point search needs.
+    bool uniform_costs() const { return m_weighted_tiles == 0; };
 
-            GridLocation loc {x1, y};
-            locs.erase(loc);
+private:
+    // Padded with impassable cells to spare bounds checks.
+    static constexpr size_t padded_width() { return width + 2; };
+    static inline size_t padded_index(int x, int y) { return (y + 1) * padded_width() + x + 1; };
+
+    inline void update_walkable(size_t node_idx) {
+        const bool passable = m_grid[node_idx]->passable();
+        const uint8_t cost = passable ? m_grid[node_idx]->move_cost() : 0;
+        assert(!passable || cost >= 1);
+        m_weighted_tiles -= m_costs[node_idx] > 1 ? 1 : 0;
+        m_weighted_tiles += cost > 1 ? 1 : 0;
+        m_costs[node_idx] = cost;
+        m_walkable[node_idx + 2 * (node_idx / width) + width + 3] = passable;
+        if (passable) {
+            m_passable_bits.set(node_idx % width, node_idx / width);
+        } else {
+            m_passable_bits.reset(node_idx % width, node_idx / width);
+        }
+    };
 
-            x1++;
+    // 4-connected passable areas, numbered from 1; impassable tiles get 0.
+    void assign_regions() {
+        std::vector<uint32_t> labels;
+        bitbfs::label_regions(m_passable_bits, labels);
+        for (size_t node_idx = 0; node_idx < m_grid.size(); node_idx++) {
+            if (labels[node_idx]) {
+                m_grid[node_idx]->set_region(labels[node_idx]);
+            } else {
+                m_grid[node_idx]->clear_region();
+            }
         }
+    };
+
+    std::array<std::unique_ptr<Node_T>, width * height> m_grid;
+    std::array<uint8_t, (width + 2) * (height + 2)> m_walkable {};
+    std::array<uint8_t, width * height> m_costs {};
+    size_t m_weighted_tiles = 0;
+    Bitboard<width, height> m_passable_bits;
+    static const int DX[8];
+    static const int DY[8];
+    static const int OFFSETS[8];
+    static const int PADDED_OFFSETS[8];
+};
 
-        // scan current line from start to the left end
-        x1 = x - 1;
-        while ((x1 >= 0) && m_grid.at(y * height + x1)->is_same_type(*first_node)) {
-            m_grid.at(y * height + x1)->set_region(reg);
+template <typename Node_T, size_t width, size_t height, int connectivity>
+constexpr int GridGraph<Node_T, width, height, connectivity>::CONNECTIVITY;
 
-            GridLocation loc {x1, y};
-            locs.erase(loc);
+template <typename Node_T, size_t width, size_t height, int connectivity>
+constexpr int GridGraph<Node_T, width, height, connectivity>::STRAIGHT_COST;
 
-            x1--;
-        }
+template <typename Node_T, size_t width, size_t height, int connectivity>
+constexpr int GridGraph<Node_T, width, height, connectivity>::DIAGONAL_COST;
 
-        // test for new scanlines to the top
-        x1 = x;
-        while (x1 < width && m_grid.at(y * height + x1)->region() == reg) {
-            if (y > 0 && m_grid.at((y - 1) * height + x1)->is_same_type(*first_node)
-                      && m_grid.at((y - 1) * height + x1)->region() == 0) {
-                flood_fill(x1, y - 1, locs, first_node);
-            }
-            x1++;
-        }
-        x1 = x - 1;
-        while (x1 >= 0 && m_grid.at(y * height + x1)->region() == reg) {
-            if (y > 0 && m_grid.at((y - 1) * height + x1)->is_same_type(*first_node)
-                      && m_grid.at((y - 1) * height + x1)->region() == 0) {
-                flood_fill(x1, y - 1, locs, first_node);
-            }
-            x1--;
-        }
+template <typename Node_T, size_t width, size_t height, int connectivity>
+const int GridGraph<Node_T, width, height, connectivity>::DX[8] = {1, 0, -1, 0, 1, -1, -1, 1};
 
-        // test for new scanlines to the bottom
-        x1 = x;
-        while (x1 < width && m_grid.at(y * height + x1)->region() == reg) {
-            if ((y + 1) < height && m_grid.at((y + 1) * height + x1)->is_same_type(*first_node)
-                                 && m_grid.at((y + 1) * height + x1)->region() == 0) {
-                flood_fill(x1, y + 1, locs, first_node);
-            }
-            x1++;
-        }
-        x1 = x - 1;
-        while (x1 >= 0 && m_grid.at(y * height + x1)->region() == reg) {
-            if ((y + 1) < height && m_grid.at((y + 1) * height + x1)->is_same_type(*first_node)
-                                 && m_grid.at((y + 1) * height + x1)->region() == 0) {
-                flood_fill(x1, y + 1, locs, first_node);
-            }
-            x1--;
-        }
-    };
+template <typename Node_T, size_t width, size_t height, int connectivity>
+const int GridGraph<Node_T, width, height, connectivity>::DY[8] = {0, -1, 0, 1, -1, -1, 1, 1};
 
-    std::array<std::unique_ptr<Node_T>, width * height> m_grid;
-    static std::array<GridLocation, 4> DIRS;
+template <typename Node_T, size_t width, size_t height, int connectivity>
+const int GridGraph<Node_T, width, height, connectivity>::OFFSETS[8] = {
+    1, -static_cast<int>(width), -1, static_cast<int>(width),
+    1 - static_cast<int>(width), -1 - static_cast<int>(width), static_cast<int>(width) - 1, static_cast<int>(width) + 1
 };
 
-template <typename Node_T, size_t width, size_t height>
-std::array<GridLocation, 4> GridGraph<Node_T, width, height>::DIRS {
-    GridLocation {1, 0},
-    GridLocation {0, -1},
-    GridLocation {-1, 0},
-    GridLocation {0, 1}
+template <typename Node_T, size_t width, size_t height, int connectivity>
+const int GridGraph<Node_T, width, height, connectivity>::PADDED_OFFSETS[8] = {
+    1, -static_cast<int>(width + 2), -1, static_cast<int>(width + 2),
+    1 - static_cast<int>(width + 2), -1 - static_cast<int>(width + 2), static_cast<int>(width + 2) - 1, static_cast<int>(width + 2) + 1
 };
 
 #endif // GRIDGRAPH_H
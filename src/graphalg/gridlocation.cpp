@@ -1,4 +1,5 @@
 #include <cmath>
+#include <cstdlib>
 
 #include "gridlocation.h"
 
@@ -11,3 +12,11 @@ double grid_distance(const GridLocation& loc1, const GridLocation& loc2)
     int ydiff(y2 - y1);
     return std::sqrt((xdiff * xdiff) + (ydiff * ydiff));
 }
+
+int manhattan_distance(const GridLocation& loc1, const GridLocation& loc2)
+{
+    int x1, y1, x2, y2;
+    std::tie(x1, y1) = loc1;
+    std::tie(x2, y2) = loc2;
+    return std::abs(x2 - x1) + std::abs(y2 - y1);
+}
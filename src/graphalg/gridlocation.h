@@ -1,6 +1,7 @@
 #ifndef GRIDLOCATION_H
 #define GRIDLOCATION_H
 
+#include <functional>
 #include <tuple>
 
 using GridLocation = std::tuple<int, int>;
@@ -17,5 +18,6 @@ struct hash<GridLocation> {
 }
 
 double grid_distance(const GridLocation& loc1, const GridLocation& loc2);
+int manhattan_distance(const GridLocation& loc1, const GridLocation& loc2);
 
 #endif // GRIDLOCATION_H
@@ -0,0 +1,61 @@
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include "gridlocation.h"
+
+// Distance estimates between grid locations as function objects.
+
+// Exact on an open 4-connected grid.
+template<int Straight = 1>
+struct ManhattanHeuristic {
+    static constexpr int estimate(int dx, int dy) { return Straight * (dx + dy); }
+
+    int operator()(const GridLocation& a, const GridLocation& b) const {
+        return estimate(std::abs(std::get<0>(a) - std::get<0>(b)), std::abs(std::get<1>(a) - std::get<1>(b)));
+    }
+};
+
+// Exact on an open 8-connected grid where a diagonal step costs Diagonal.
+// With the default a diagonal is two straight steps, i.e. Manhattan.
+template<int Straight = 1, int Diagonal = 2 * Straight>
+struct OctileHeuristic {
+    static constexpr int estimate(int dx, int dy) {
+        return Straight * (dx + dy) + (Diagonal - 2 * Straight) * (dx < dy ? dx : dy);
+    }
+
+    int operator()(const GridLocation& a, const GridLocation& b) const {
+        return estimate(std::abs(std::get<0>(a) - std::get<0>(b)), std::abs(std::get<1>(a) - std::get<1>(b)));
+    }
+};
+
+// Straight line distance times Scale, rounded down.
+template<int Scale = 1>
+struct EuclideanHeuristic {
+    static constexpr int estimate(int dx, int dy) { return isqrt(Scale * Scale * (dx * dx + dy * dy)); }
+
+    int operator()(const GridLocation& a, const GridLocation& b) const {
+        int dx = std::get<0>(a) - std::get<0>(b), dy = std::get<1>(a) - std::get<1>(b);
+        return static_cast<int>(std::sqrt(static_cast<double>(Scale * Scale * (dx * dx + dy * dy))));
+    }
+
+private:
+    // Largest r in [low, high] with r * r <= n.
+    static constexpr int isqrt(int n, int low, int high) {
+        return low >= high ? low :
+            ((low + high + 1) / 2 <= n / ((low + high + 1) / 2) ? isqrt(n, (low + high + 1) / 2, high)
+                                                                : isqrt(n, low, (low + high + 1) / 2 - 1));
+    }
+
+    static constexpr int isqrt(int n) { return n < 2 ? n : isqrt(n, 1, n / 2 < 46340 ? n / 2 : 46340); }
+};
+
+static_assert(ManhattanHeuristic<>::estimate(3, 4) == 7, "Manhattan");
+static_assert(OctileHeuristic<10, 14>::estimate(3, 4) == 52, "octile");
+static_assert(OctileHeuristic<>::estimate(3, 4) == ManhattanHeuristic<>::estimate(3, 4), "octile");
+static_assert(EuclideanHeuristic<>::estimate(3, 4) == 5, "Euclidean");
+static_assert(EuclideanHeuristic<10>::estimate(1, 1) == 14, "Euclidean");
+
+#endif // HEURISTICS_H
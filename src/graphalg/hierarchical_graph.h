@@ -0,0 +1,312 @@
+#ifndef HIERARCHICAL_GRAPH_H
+#define HIERARCHICAL_GRAPH_H
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include "gridlocation.h"
+#include "search_workspace.h"
+#include "bucket_queue.h"
+#include "a_star_search.h"
+
+// Grid graph seen through a rectangular window, with the same numbering.
+template<typename Graph>
+class ClusterView
+{
+public:
+    using Node = typename Graph::Node;
+
+    ClusterView(const Graph& graph, int x, int y, int width, int height)
+        : m_graph(graph), m_x(x), m_y(y), m_width(width), m_height(height) {};
+
+    static constexpr size_t size() { return Graph::size(); };
+    inline NodeIndex index(Node loc) const { return m_graph.index(loc); };
+    inline Node location(NodeIndex idx) const { return m_graph.location(idx); };
+    inline int cost(Node a, Node b) const { return m_graph.cost(a, b); };
+
+    inline bool contains(Node loc) const {
+        int x, y;
+        std::tie(x, y) = loc;
+        return x >= m_x && x < m_x + m_width && y >= m_y && y < m_y + m_height;
+    };
+
+    template<typename Visitor>
+    inline void for_each_neighbor(const Node& loc, Visitor visit) const {
+        m_graph.for_each_neighbor(loc, [this, &visit](const Node& next) {
+            if (contains(next)) {
+                visit(next);
+            }
+        });
+    }
+
+private:
+    const Graph& m_graph;
+    int m_x, m_y, m_width, m_height;
+};
+
+// HPA* abstraction of a grid graph split into square clusters.
+template<typename Graph>
+class HierarchicalGraph
+{
+public:
+    using Node = typename Graph::Node;
+
+    HierarchicalGraph(int cluster_size = 10)
+        : m_graph(nullptr)
+        , m_cluster_size(cluster_size)
+        , m_clusters_x(0)
+        , m_clusters_y(0) {};
+
+    // Has to be called again whenever the graph's passability changes.
+    void build(const Graph& graph) {
+        m_graph = &graph;
+        m_clusters_x = (Graph::grid_width() + m_cluster_size - 1) / m_cluster_size;
+        m_clusters_y = (Graph::grid_height() + m_cluster_size - 1) / m_cluster_size;
+        m_nodes.clear();
+        m_cluster_nodes.assign(m_clusters_x * m_clusters_y, std::vector<uint32_t>());
+        m_node_at.assign(Graph::size(), NO_NODE);
+
+        for (int cy = 0; cy < m_clusters_y; cy++) {
+            for (int cx = 0; cx < m_clusters_x; cx++) {
+                if (cx + 1 < m_clusters_x) {
+                    add_entrances(cx, cy, 1, 0);
+                }
+                if (cy + 1 < m_clusters_y) {
+                    add_entrances(cx, cy, 0, 1);
+                }
+            }
+        }
+
+        for (size_t cluster = 0; cluster < m_cluster_nodes.size(); cluster++) {
+            auto view = cluster_view(cluster);
+            for (auto from : m_cluster_nodes[cluster]) {
+                cluster_distances(view, m_nodes[from].loc);
+                for (auto to : m_cluster_nodes[cluster]) {
+                    NodeIndex idx = m_graph->index(m_nodes[to].loc);
+                    if (to != from && m_workspace.reached(idx)) {
+                        m_nodes[from].edges.push_back(Edge {to, m_workspace.cost(idx)});
+                    }
+                }
+            }
+        }
+    };
+
+    size_t node_count() const { return m_nodes.size(); };
+
+    std::vector<Node> find_path(Node start, Node goal) {
+        std::vector<Node> path;
+        auto waypoints = abstract_path(start, goal);
+        for (size_t i = 1; i < waypoints.size(); i++) {
+            auto segment = refine(waypoints[i - 1], waypoints[i]);
+            path.insert(path.end(), segment.begin() + (path.empty() ? 0 : 1), segment.end());
+        }
+        if (path.empty() && waypoints.size() == 1) {
+            path.push_back(start);
+        }
+        return path;
+    };
+
+private:
+    // Consecutive waypoints are adjacent or in the same cluster.
+    std::vector<Node> abstract_path(Node start, Node goal) {
+        assert(m_graph != nullptr);
+        std::vector<Node> path;
+        const uint32_t start_id = m_nodes.size();
+        const uint32_t goal_id = start_id + 1;
+
+        // Temporarily connect start and goal to the nodes of their clusters.
+        m_start_edges.clear();
+        m_goal_cost.assign(m_nodes.size() + 2, NO_EDGE);
+        const size_t start_cluster = cluster_of(start);
+        const size_t goal_cluster = cluster_of(goal);
+        cluster_distances(cluster_view(start_cluster), start);
+        for (auto id : m_cluster_nodes[start_cluster]) {
+            NodeIndex idx = m_graph->index(m_nodes[id].loc);
+            if (m_workspace.reached(idx)) {
+                m_start_edges.push_back(Edge {id, m_workspace.cost(idx)});
+            }
+        }
+        if (start_cluster == goal_cluster && m_workspace.reached(m_graph->index(goal))) {
+            m_start_edges.push_back(Edge {goal_id, m_workspace.cost(m_graph->index(goal))});
+        }
+        cluster_distances(cluster_view(goal_cluster), goal);
+        for (auto id : m_cluster_nodes[goal_cluster]) {
+            NodeIndex idx = m_graph->index(m_nodes[id].loc);
+            if (m_workspace.reached(idx)) {
+                m_goal_cost[id] = m_workspace.cost(idx);
+            }
+        }
+
+        auto loc = [&](uint32_t id) {
+            return id == start_id ? start : (id == goal_id ? goal : m_nodes[id].loc);
+        };
+        const typename Graph::Heuristic heuristic;
+        auto& frontier = m_abstract_workspace.frontier;
+        m_abstract_workspace.reset(m_nodes.size() + 2);
+        m_abstract_workspace.relax(start_id, 0, start_id);
+        frontier.put(start_id, 0);
+
+        auto visit = [&](uint32_t current, const Edge& edge) {
+            int new_cost = m_abstract_workspace.cost(current) + edge.cost;
+            if (!m_abstract_workspace.reached(edge.to) || new_cost < m_abstract_workspace.cost(edge.to)) {
+                m_abstract_workspace.relax(edge.to, new_cost, current);
+                frontier.put(edge.to, new_cost + heuristic(loc(edge.to), goal));
+            }
+        };
+
+        while (!frontier.empty()) {
+            auto current = frontier.get();
+            if (current == goal_id) {
+                break;
+            }
+            if (current == start_id) {
+                for (auto& edge : m_start_edges) {
+                    visit(current, edge);
+                }
+                continue;
+            }
+            for (auto& edge : m_nodes[current].edges) {
+                visit(current, edge);
+            }
+            if (m_goal_cost[current] != NO_EDGE) {
+                visit(current, Edge {goal_id, m_goal_cost[current]});
+            }
+        }
+
+        if (!m_abstract_workspace.reached(goal_id)) {
+            return path;
+        }
+        for (uint32_t id = goal_id; ; id = m_abstract_workspace.came_from(id)) {
+            if (path.empty() || path.back() != loc(id)) {
+                path.push_back(loc(id));
+            }
+            if (id == start_id) {
+                break;
+            }
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    };
+
+    // Grid path between two consecutive abstract_path() waypoints.
+    std::vector<Node> refine(Node from, Node to) {
+        assert(m_graph != nullptr);
+        // Diagonals need their corners checked by the search.
+        const int dir = Graph::direction(std::get<0>(to) - std::get<0>(from), std::get<1>(to) - std::get<1>(from));
+        if (from == to || (dir >= 0 && dir < 4)) {
+            std::vector<Node> path {from};
+            if (from != to) {
+                path.push_back(to);
+            }
+            return path;
+        }
+        auto view = cluster_view(cluster_of(from));
+        assert(view.contains(to));
+        return a_star_search(view, from, to, typename Graph::Heuristic(), m_workspace);
+    };
+
+    struct Edge {
+        uint32_t to;
+        int cost;
+    };
+
+    struct AbstractNode {
+        Node loc;
+        std::vector<Edge> edges;
+    };
+
+    static const uint32_t NO_NODE = UINT32_MAX;
+    static const int NO_EDGE = -1;
+
+    // Entrances between cluster (cx, cy) and its neighbour at (cx + dx, cy + dy).
+    void add_entrances(int cx, int cy, int dx, int dy) {
+        // Border tiles on this side, walking along the border.
+        const int x0 = dx ? (cx + 1) * m_cluster_size - 1 : cx * m_cluster_size;
+        const int y0 = dy ? (cy + 1) * m_cluster_size - 1 : cy * m_cluster_size;
+        const int border_length = std::min<int>(m_cluster_size,
+                                                dx ? Graph::grid_height() - y0 : Graph::grid_width() - x0);
+        auto side = [&](int i) { return Node(x0 + dy * i, y0 + dx * i); };
+        auto other_side = [&](int i) { return Node(x0 + dy * i + dx, y0 + dx * i + dy); };
+        auto open = [&](int i) {
+            return m_graph->passable(side(i)) && m_graph->passable(other_side(i));
+        };
+
+        int i = 0;
+        while (i < border_length) {
+            if (!open(i)) {
+                i++;
+                continue;
+            }
+            int run_start = i;
+            while (i < border_length && open(i)) {
+                i++;
+            }
+            int run_end = i - 1;
+            if (run_end - run_start + 1 < ENTRANCE_SPLIT_LENGTH) {
+                int middle = (run_start + run_end) / 2;
+                add_transition(side(middle), other_side(middle));
+            } else {
+                add_transition(side(run_start), other_side(run_start));
+                add_transition(side(run_end), other_side(run_end));
+            }
+        }
+    };
+
+    void add_transition(Node a, Node b) {
+        uint32_t id_a = node_at(a);
+        uint32_t id_b = node_at(b);
+        m_nodes[id_a].edges.push_back(Edge {id_b, m_graph->cost(a, b)});
+        m_nodes[id_b].edges.push_back(Edge {id_a, m_graph->cost(b, a)});
+    };
+
+    uint32_t node_at(Node loc) {
+        NodeIndex idx = m_graph->index(loc);
+        if (m_node_at[idx] == NO_NODE) {
+            m_node_at[idx] = m_nodes.size();
+            m_cluster_nodes[cluster_of(loc)].push_back(m_nodes.size());
+            m_nodes.push_back(AbstractNode {loc, std::vector<Edge>()});
+        }
+        return m_node_at[idx];
+    };
+
+    size_t cluster_of(Node loc) const {
+        int x, y;
+        std::tie(x, y) = loc;
+        return (y / m_cluster_size) * m_clusters_x + x / m_cluster_size;
+    };
+
+    ClusterView<Graph> cluster_view(size_t cluster) const {
+        return ClusterView<Graph>(*m_graph,
+                                  (cluster % m_clusters_x) * m_cluster_size,
+                                  (cluster / m_clusters_x) * m_cluster_size,
+                                  m_cluster_size, m_cluster_size);
+    };
+
+    // Dijkstra from source inside the view; results are left in m_workspace.
+    void cluster_distances(const ClusterView<Graph>& view, Node source) {
+        dijkstra(view, {view.index(source)}, m_workspace);
+    };
+
+    // Entrances at least this long get a transition at both ends.
+    static const int ENTRANCE_SPLIT_LENGTH = 6;
+
+    const Graph* m_graph;
+    int m_cluster_size;
+    int m_clusters_x;
+    int m_clusters_y;
+    std::vector<AbstractNode> m_nodes;
+    std::vector<std::vector<uint32_t> > m_cluster_nodes;
+    std::vector<uint32_t> m_node_at; // grid index -> abstract node
+    std::vector<Edge> m_start_edges;
+    std::vector<int> m_goal_cost;
+    SearchWorkspace<int, BucketQueue<int> > m_workspace;
+    SearchWorkspace<int, BucketQueue<int> > m_abstract_workspace;
+};
+
+template<typename Graph>
+const uint32_t HierarchicalGraph<Graph>::NO_NODE;
+
+template<typename Graph>
+const int HierarchicalGraph<Graph>::NO_EDGE;
+
+#endif // HIERARCHICAL_GRAPH_H
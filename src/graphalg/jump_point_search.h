@@ -0,0 +1,242 @@
+#ifndef JUMP_POINT_SEARCH_H
+#define JUMP_POINT_SEARCH_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <type_traits>
+#include "search_workspace.h"
+#include "a_star_search.h"
+
+// Jump Point Search for grids with uniform straight and diagonal costs.
+namespace jps {
+
+// The graph's padded border stops jumps without bounds checks.
+template<typename Graph>
+inline bool walkable(const Graph &graph, int x, int y)
+{
+    return graph.passable(GridLocation(x, y));
+}
+
+template<typename Graph>
+bool jump_horizontal(const Graph &graph, int x, int y, int dx,
+                     const GridLocation &goal, GridLocation &jump_point)
+{
+    while (true) {
+        x += dx;
+        if (!walkable(graph, x, y)) {
+            return false;
+        }
+        if (GridLocation(x, y) == goal ||
+                (walkable(graph, x, y - 1) && !walkable(graph, x - dx, y - 1)) ||
+                (walkable(graph, x, y + 1) && !walkable(graph, x - dx, y + 1))) {
+            jump_point = GridLocation(x, y);
+            return true;
+        }
+    }
+}
+
+template<typename Graph>
+bool jump_vertical(const Graph &graph, int x, int y, int dy,
+                   const GridLocation &goal, GridLocation &jump_point)
+{
+    GridLocation ignored;
+    while (true) {
+        y += dy;
+        if (!walkable(graph, x, y)) {
+            return false;
+        }
+        if (GridLocation(x, y) == goal ||
+                jump_horizontal(graph, x, y, 1, goal, ignored) ||
+                jump_horizontal(graph, x, y, -1, goal, ignored)) {
+            jump_point = GridLocation(x, y);
+            return true;
+        }
+    }
+}
+
+inline int sign(int value)
+{
+    return (value > 0) - (value < 0);
+}
+
+// Runs from (x, y) by (dx, dy) on an 8-connected grid until a jump point.
+template<typename Graph>
+bool jump(const Graph &graph, int x, int y, int dx, int dy,
+          const GridLocation &goal, GridLocation &jump_point)
+{
+    GridLocation ignored;
+    while (true) {
+        if (!walkable(graph, x + dx, y) || !walkable(graph, x, y + dy)) {
+            return false; // would cut a corner, or the straight run is blocked
+        }
+        x += dx;
+        y += dy;
+        if (!walkable(graph, x, y)) {
+            return false;
+        }
+        if (GridLocation(x, y) == goal) {
+            jump_point = goal;
+            return true;
+        }
+        bool stop;
+        if (dx != 0 && dy != 0) {
+            stop = jump(graph, x, y, dx, 0, goal, ignored) || jump(graph, x, y, 0, dy, goal, ignored);
+        } else if (dx != 0) {
+            stop = (walkable(graph, x, y - 1) && !walkable(graph, x - dx, y - 1)) ||
+                   (walkable(graph, x, y + 1) && !walkable(graph, x - dx, y + 1));
+        } else {
+            stop = (walkable(graph, x - 1, y) && !walkable(graph, x - 1, y - dy)) ||
+                   (walkable(graph, x + 1, y) && !walkable(graph, x + 1, y - dy));
+        }
+        if (stop) {
+            jump_point = GridLocation(x, y);
+            return true;
+        }
+    }
+}
+
+// Jump points after (x, y) entered by (dx, dy). Returns how many.
+template<typename Graph>
+size_t successors(const Graph &graph, int x, int y, int dx, int dy, const GridLocation &goal,
+                  GridLocation *successors, std::integral_constant<int, 4>)
+{
+    size_t count(0);
+    if (dx == 0 && dy == 0) {
+        count += jump_horizontal(graph, x, y, 1, goal, successors[count]);
+        count += jump_horizontal(graph, x, y, -1, goal, successors[count]);
+        count += jump_vertical(graph, x, y, 1, goal, successors[count]);
+        count += jump_vertical(graph, x, y, -1, goal, successors[count]);
+    } else if (dy == 0) {
+        count += jump_horizontal(graph, x, y, dx, goal, successors[count]);
+        for (int side : {-1, 1}) {
+            if (walkable(graph, x, y + side) && !walkable(graph, x - dx, y + side)) {
+                count += jump_vertical(graph, x, y, side, goal, successors[count]);
+            }
+        }
+    } else {
+        count += jump_vertical(graph, x, y, dy, goal, successors[count]);
+        count += jump_horizontal(graph, x, y, 1, goal, successors[count]);
+        count += jump_horizontal(graph, x, y, -1, goal, successors[count]);
+    }
+    return count;
+}
+
+template<typename Graph>
+size_t successors(const Graph &graph, int x, int y, int dx, int dy, const GridLocation &goal,
+                  GridLocation *successors, std::integral_constant<int, 8>)
+{
+    size_t count(0);
+    if (dx == 0 && dy == 0) {
+        for (int dir = 0; dir < 8; dir++) {
+            auto next = Graph::step(GridLocation(x, y), dir);
+            count += jump(graph, x, y, std::get<0>(next) - x, std::get<1>(next) - y, goal, successors[count]);
+        }
+    } else if (dx != 0 && dy != 0) {
+        count += jump(graph, x, y, dx, 0, goal, successors[count]);
+        count += jump(graph, x, y, 0, dy, goal, successors[count]);
+        count += jump(graph, x, y, dx, dy, goal, successors[count]);
+    } else if (dx != 0) {
+        count += jump(graph, x, y, dx, 0, goal, successors[count]);
+        for (int side : {-1, 1}) {
+            if (walkable(graph, x, y + side)) {
+                count += jump(graph, x, y, 0, side, goal, successors[count]);
+                count += jump(graph, x, y, dx, side, goal, successors[count]);
+            }
+        }
+    } else {
+        count += jump(graph, x, y, 0, dy, goal, successors[count]);
+        for (int side : {-1, 1}) {
+            if (walkable(graph, x + side, y)) {
+                count += jump(graph, x, y, side, 0, goal, successors[count]);
+                count += jump(graph, x, y, side, dy, goal, successors[count]);
+            }
+        }
+    }
+    return count;
+}
+
+} // namespace jps
+
+// Same contract as a_star_search(), on unweighted graphs only.
+template<typename Graph, typename Workspace, typename Heuristic>
+std::vector<typename Graph::Node> jump_point_search(const Graph &graph,
+                                                    typename Graph::Node start,
+                                                    typename Graph::Node goal,
+                                                    Heuristic heuristic,
+                                                    Workspace &workspace)
+{
+    if (!graph.uniform_costs()) {
+        return a_star_search(graph, start, goal, heuristic, workspace);
+    }
+
+    const NodeIndex start_idx = graph.index(start);
+    const NodeIndex goal_idx = graph.index(goal);
+    auto &frontier = workspace.frontier;
+
+    workspace.reset(graph.size());
+    workspace.relax(start_idx, 0, start_idx);
+    frontier.put(start_idx, 0);
+
+    GridLocation successors[8];
+    while (!frontier.empty()) {
+        auto current = frontier.get();
+        workspace.stats.popped();
+
+        if (current == goal_idx) {
+            break;
+        }
+
+        workspace.stats.expanded();
+        int x, y, px, py;
+        std::tie(x, y) = graph.location(current);
+        std::tie(px, py) = graph.location(workspace.came_from(current));
+        const int dx = jps::sign(x - px);
+        const int dy = jps::sign(y - py);
+
+        size_t count = jps::successors(graph, x, y, dx, dy, goal, successors,
+                                       std::integral_constant<int, Graph::CONNECTIVITY>());
+        for (size_t i = 0; i < count; i++) {
+            int nx, ny;
+            std::tie(nx, ny) = successors[i];
+            NodeIndex next_idx = graph.index(successors[i]);
+            // Runs are straight or diagonal, where the graph's heuristic is exact.
+            int new_cost = workspace.cost(current) +
+                           Graph::Heuristic::estimate(std::abs(nx - x), std::abs(ny - y));
+            const bool reached = workspace.reached(next_idx);
+            if (!reached || new_cost < workspace.cost(next_idx)) {
+                workspace.relax(next_idx, new_cost, current);
+                frontier.put(next_idx, new_cost + heuristic(successors[i], goal));
+                workspace.stats.pushed(reached);
+            }
+        }
+    }
+
+    // Generate path, filling in the straight runs between jump points
+    std::vector<typename Graph::Node> path;
+    if (!workspace.reached(goal_idx)) {
+        workspace.stats.end(0);
+        return path;
+    }
+    auto current = goal_idx;
+    path.push_back(goal);
+    while (current != start_idx) {
+        auto parent = workspace.came_from(current);
+        int x, y, px, py;
+        std::tie(x, y) = graph.location(current);
+        std::tie(px, py) = graph.location(parent);
+        const int dx = jps::sign(px - x);
+        const int dy = jps::sign(py - y);
+        while (x != px || y != py) {
+            x += dx;
+            y += dy;
+            path.emplace_back(x, y);
+        }
+        current = parent;
+    }
+    std::reverse(path.begin(), path.end());
+    workspace.stats.end(path.size());
+    return path;
+}
+
+#endif // JUMP_POINT_SEARCH_H
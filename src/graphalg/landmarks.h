@@ -0,0 +1,98 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include "gridlocation.h"
+#include "search_workspace.h"
+#include "bucket_queue.h"
+#include "a_star_search.h"
+
+// ALT heuristic: A*, Landmarks and the Triangle inequality.
+template<typename Graph>
+class LandmarkHeuristic
+{
+public:
+    using Node = typename Graph::Node;
+
+    LandmarkHeuristic(size_t landmarks_per_region = 4)
+        : m_graph(nullptr)
+        , m_landmarks_per_region(landmarks_per_region) {};
+
+    // Has to be called again whenever the graph's passability changes.
+    void build(const Graph& graph) {
+        m_graph = &graph;
+        m_landmarks.clear();
+        m_distances.assign(Graph::size() * m_landmarks_per_region, 0);
+
+        std::unordered_map<uint32_t, std::vector<NodeIndex> > regions;
+        for (NodeIndex idx = 0; idx < Graph::size(); idx++) {
+            int x, y;
+            std::tie(x, y) = graph.location(idx);
+            if (graph.passable(GridLocation(x, y))) {
+                regions[graph.at(x, y)->region()].push_back(idx);
+            }
+        }
+
+        std::vector<int> closest_landmark(Graph::size());
+        for (auto& region : regions) {
+            auto& tiles = region.second;
+            if (tiles.size() < 2) {
+                continue;
+            }
+            // The tile farthest from an arbitrary one is the first landmark.
+            distances_from(tiles.front());
+            NodeIndex landmark = farthest(tiles, [this](NodeIndex idx) { return m_workspace.cost(idx); });
+            for (auto idx : tiles) {
+                closest_landmark[idx] = INT32_MAX;
+            }
+
+            for (size_t k = 0; k < m_landmarks_per_region; k++) {
+                m_landmarks.push_back(landmark);
+                distances_from(landmark);
+                for (auto idx : tiles) {
+                    int distance = m_workspace.cost(idx);
+                    m_distances[idx * m_landmarks_per_region + k] = distance;
+                    closest_landmark[idx] = std::min(closest_landmark[idx], distance);
+                }
+                landmark = farthest(tiles, [&closest_landmark](NodeIndex idx) { return closest_landmark[idx]; });
+            }
+        }
+    };
+
+    size_t landmark_count() const { return m_landmarks.size(); };
+
+    // Admissible and consistent for tiles of the same region.
+    int operator()(Node a, Node b) const {
+        int estimate = typename Graph::Heuristic()(a, b);
+        const int* da = &m_distances[m_graph->index(a) * m_landmarks_per_region];
+        const int* db = &m_distances[m_graph->index(b) * m_landmarks_per_region];
+        for (size_t k = 0; k < m_landmarks_per_region; k++) {
+            estimate = std::max(estimate, std::abs(da[k] - db[k]));
+        }
+        return estimate;
+    };
+
+private:
+    void distances_from(NodeIndex source) {
+        dijkstra(*m_graph, {source}, m_workspace);
+    };
+
+    template<typename Distance>
+    static NodeIndex farthest(const std::vector<NodeIndex>& tiles, Distance distance) {
+        return *std::max_element(tiles.begin(), tiles.end(), [&distance](NodeIndex a, NodeIndex b) {
+            return distance(a) < distance(b);
+        });
+    }
+
+    const Graph* m_graph;
+    size_t m_landmarks_per_region;
+    std::vector<NodeIndex> m_landmarks;
+    std::vector<int> m_distances; // per tile, to each landmark of its region
+    SearchWorkspace<int, BucketQueue<int> > m_workspace;
+};
+
+#endif // LANDMARKS_H
@@ -0,0 +1,63 @@
+#ifndef NEAREST_TARGET_H
+#define NEAREST_TARGET_H
+
+#include <vector>
+#include "search_workspace.h"
+
+// A* towards start from all of goals, for the nearest one by path.
+template<typename Graph, typename Workspace, typename Heuristic, typename Goals>
+std::vector<typename Graph::Node> path_to_nearest(const Graph &graph,
+                                                  typename Graph::Node start,
+                                                  const Goals &goals,
+                                                  Heuristic heuristic,
+                                                  Workspace &workspace)
+{
+    const NodeIndex start_idx = graph.index(start);
+    auto &frontier = workspace.frontier;
+    workspace.reset(graph.size());
+    for (auto& goal : goals) {
+        if (graph.in_bounds(goal) && graph.passable(goal)) {
+            NodeIndex goal_idx = graph.index(goal);
+            workspace.relax(goal_idx, 0, goal_idx);
+            frontier.put(goal_idx, heuristic(goal, start));
+        }
+    }
+
+    while (!frontier.empty()) {
+        auto current = frontier.get();
+        workspace.stats.popped();
+        if (current == start_idx) {
+            break;
+        }
+
+        workspace.stats.expanded();
+        auto current_loc = graph.location(current);
+        graph.for_each_neighbor(current_loc, [&](const typename Graph::Node& next) {
+            NodeIndex next_idx = graph.index(next);
+            int new_cost = workspace.cost(current) + graph.cost(current_loc, next);
+            const bool reached = workspace.reached(next_idx);
+            if (!reached || new_cost < workspace.cost(next_idx)) {
+                workspace.relax(next_idx, new_cost, current);
+                frontier.put(next_idx, new_cost + heuristic(next, start));
+                workspace.stats.pushed(reached);
+            }
+        });
+    }
+
+    // Every node came from the next one towards its goal.
+    std::vector<typename Graph::Node> path;
+    if (!workspace.reached(start_idx)) {
+        workspace.stats.end(0);
+        return path;
+    }
+    NodeIndex current = start_idx;
+    path.push_back(start);
+    while (workspace.came_from(current) != current) {
+        current = workspace.came_from(current);
+        path.push_back(graph.location(current));
+    }
+    workspace.stats.end(path.size());
+    return path;
+}
+
+#endif // NEAREST_TARGET_H
@@ -0,0 +1,67 @@
+#include <algorithm>
+
+#include "path_cache.h"
+
+PathCache::PathCache(size_t capacity)
+    : m_capacity(capacity)
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+bool PathCache::find(const GridLocation& start, const GridLocation& goal, uint32_t region,
+                     CompactPath& path)
+{
+    auto found = m_index.find(Key {start, goal, region});
+    if (found == m_index.end()) {
+        m_misses++;
+        return false;
+    }
+    m_hits++;
+    m_entries.splice(m_entries.begin(), m_entries, found->second);
+
+    path = found->second->path;
+    return true;
+}
+
+void PathCache::insert(const GridLocation& start, const GridLocation& goal, uint32_t region,
+                       const CompactPath& path, int cost)
+{
+    if (path.empty() || m_capacity == 0) {
+        return;
+    }
+
+    Key key {start, goal, region};
+    auto found = m_index.find(key);
+    if (found != m_index.end()) {
+        m_entries.erase(found->second);
+        m_index.erase(found);
+    } else if (m_entries.size() == m_capacity) {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.cost = cost;
+    entry.path = path;
+    std::tie(entry.min_x, entry.min_y) = path.start();
+    std::tie(entry.max_x, entry.max_y) = path.start();
+    // Moves are straight lines, within the box of their ends.
+    path.for_each_waypoint([&](const GridLocation& loc) {
+        int x, y;
+        std::tie(x, y) = loc;
+        entry.min_x = std::min<int>(entry.min_x, x);
+        entry.min_y = std::min<int>(entry.min_y, y);
+        entry.max_x = std::max<int>(entry.max_x, x);
+        entry.max_y = std::max<int>(entry.max_y, y);
+    });
+    m_entries.push_front(std::move(entry));
+    m_index[key] = m_entries.begin();
+}
+
+void PathCache::clear()
+{
+    m_entries.clear();
+    m_index.clear();
+}
@@ -0,0 +1,101 @@
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include "gridlocation.h"
+#include "compact_path.h"
+
+// Least recently used grid paths by their end points and region.
+class PathCache
+{
+public:
+    PathCache(size_t capacity = 256);
+
+    // Fills path and returns true if it's cached.
+    bool find(const GridLocation& start, const GridLocation& goal, uint32_t region,
+              CompactPath& path);
+    // True if none of the other goals can be nearer than the cached one.
+    template<typename Goals, typename Distance>
+    bool find_nearest(const GridLocation& start, const Goals& goals, uint32_t region,
+                      Distance distance, CompactPath& path) {
+        auto best = m_entries.end();
+        for (auto& goal : goals) {
+            auto found = m_index.find(Key {start, goal, region});
+            if (found != m_index.end() && (best == m_entries.end() || found->second->cost < best->cost)) {
+                best = found->second;
+            }
+        }
+        for (auto& goal : goals) {
+            if (best != m_entries.end() && goal != best->key.goal && distance(start, goal) < best->cost) {
+                best = m_entries.end();
+            }
+        }
+        if (best == m_entries.end()) {
+            m_misses++;
+            return false;
+        }
+        m_hits++;
+        m_entries.splice(m_entries.begin(), m_entries, best);
+        path = best->path;
+        return true;
+    }
+    void insert(const GridLocation& start, const GridLocation& goal, uint32_t region,
+                const CompactPath& path, int cost);
+    // Call after the passability or cost of loc has changed.
+    template<typename Distance>
+    void invalidate(const GridLocation& loc, Distance distance) {
+        int x, y;
+        std::tie(x, y) = loc;
+        for (auto entry = m_entries.begin(); entry != m_entries.end(); ) {
+            bool in_box = x >= entry->min_x && x <= entry->max_x && y >= entry->min_y && y <= entry->max_y;
+            bool on_detour = distance(entry->key.start, loc) + distance(loc, entry->key.goal) <= entry->cost;
+            if (in_box || on_detour) {
+                m_index.erase(entry->key);
+                entry = m_entries.erase(entry);
+            } else {
+                ++entry;
+            }
+        }
+    }
+    void clear();
+
+    size_t size() const { return m_entries.size(); };
+    size_t hits() const { return m_hits; };
+    size_t misses() const { return m_misses; };
+
+private:
+    struct Key {
+        GridLocation start;
+        GridLocation goal;
+        uint32_t region;
+
+        bool operator==(const Key& other) const {
+            return start == other.start && goal == other.goal && region == other.region;
+        };
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            std::hash<GridLocation> hash;
+            return hash(key.start) * 31 + hash(key.goal) + key.region;
+        };
+    };
+
+    struct Entry {
+        Key key;
+        int cost;
+        int16_t min_x, min_y, max_x, max_y;
+        CompactPath path;
+    };
+
+    size_t m_capacity;
+    size_t m_hits;
+    size_t m_misses;
+    std::list<Entry> m_entries; // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+};
+
+#endif // PATH_CACHE_H
@@ -0,0 +1,34 @@
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+// Binary heap keeping its storage between searches: clear() drops the
+// elements but not the capacity.
+template<typename T, typename Number=int>
+struct PriorityQueue {
+    using PQElement = std::pair<Number, T>;
+    std::vector<PQElement> elements;
+
+    inline bool empty() const { return elements.empty(); }
+
+    inline void clear() { elements.clear(); }
+
+    inline void put(T item, Number priority) {
+        elements.emplace_back(priority, item);
+        std::push_heap(elements.begin(), elements.end(), std::greater<PQElement>());
+    }
+
+    inline Number top_priority() const { return elements.front().first; }
+
+    inline T get() {
+        std::pop_heap(elements.begin(), elements.end(), std::greater<PQElement>());
+        T best_item = elements.back().second;
+        elements.pop_back();
+        return best_item;
+    }
+};
+
+#endif // PRIORITY_QUEUE_H
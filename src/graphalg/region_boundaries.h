@@ -0,0 +1,101 @@
+#ifndef REGION_BOUNDARIES_H
+#define REGION_BOUNDARIES_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include "gridlocation.h"
+#include "search_workspace.h"
+
+// The tile of a region closest to a goal outside it, looked up among the
+// region's border tiles bucketed by blocks of the grid.
+template<typename Graph>
+class RegionBoundaries
+{
+public:
+    // Has to be called again whenever the graph's passability changes.
+    void build(const Graph& graph) {
+        m_blocks.assign(blocks_x() * blocks_y(), std::vector<Entry>());
+        for (NodeIndex idx = 0; idx < Graph::size(); idx++) {
+            int x, y;
+            std::tie(x, y) = graph.location(idx);
+            if (graph.passable(GridLocation(x, y)) && borders_impassable(graph, x, y)) {
+                m_blocks[y / BLOCK * blocks_x() + x / BLOCK].push_back(Entry {graph.at(x, y)->region(), idx});
+            }
+        }
+        for (auto& block : m_blocks) {
+            std::sort(block.begin(), block.end());
+        }
+    };
+
+    // False if there is no tile outside the region.
+    bool closest(const Graph& graph, uint32_t region, const GridLocation& goal, GridLocation& tile) const {
+        int goal_x, goal_y;
+        std::tie(goal_x, goal_y) = goal;
+        const int bx = goal_x / BLOCK, by = goal_y / BLOCK;
+        const int rings = std::max(std::max(bx, blocks_x() - 1 - bx), std::max(by, blocks_y() - 1 - by));
+
+        long best = -1;
+        NodeIndex best_idx = 0;
+        for (int ring = 0; ring <= rings; ring++) {
+            // Tiles of the ring are at least this far off along one axis.
+            const long near = ring > 0 ? (ring - 1) * BLOCK + 1 : 0;
+            if (best >= 0 && near * near > best) {
+                break;
+            }
+            for (int y = by - ring; y <= by + ring; y++) {
+                // Whole rows at the top and bottom, two blocks in between.
+                const int step = y == by - ring || y == by + ring ? 1 : 2 * ring;
+                for (int x = bx - ring; x <= bx + ring; x += step) {
+                    if (x < 0 || y < 0 || x >= blocks_x() || y >= blocks_y()) {
+                        continue;
+                    }
+                    auto& block = m_blocks[y * blocks_x() + x];
+                    auto first = std::lower_bound(block.begin(), block.end(), Entry {region, 0});
+                    for (auto it = first; it != block.end() && it->region == region; ++it) {
+                        int tile_x, tile_y;
+                        std::tie(tile_x, tile_y) = graph.location(it->idx);
+                        const long dx = tile_x - goal_x, dy = tile_y - goal_y;
+                        const long distance = dx * dx + dy * dy;
+                        if (best < 0 || distance < best || (distance == best && it->idx < best_idx)) {
+                            best = distance;
+                            best_idx = it->idx;
+                        }
+                    }
+                }
+            }
+        }
+        if (best < 0) {
+            return false;
+        }
+        tile = graph.location(best_idx);
+        return true;
+    };
+
+private:
+    static const int BLOCK = 8;
+
+    struct Entry {
+        uint32_t region;
+        NodeIndex idx;
+
+        bool operator<(const Entry& other) const {
+            return region < other.region || (region == other.region && idx < other.idx);
+        };
+    };
+
+    static constexpr int blocks_x() { return (Graph::grid_width() + BLOCK - 1) / BLOCK; };
+    static constexpr int blocks_y() { return (Graph::grid_height() + BLOCK - 1) / BLOCK; };
+
+    static bool borders_impassable(const Graph& graph, int x, int y) {
+        return (x > 0 && !graph.passable(GridLocation(x - 1, y))) ||
+               (y > 0 && !graph.passable(GridLocation(x, y - 1))) ||
+               (x + 1 < static_cast<int>(Graph::grid_width()) && !graph.passable(GridLocation(x + 1, y))) ||
+               (y + 1 < static_cast<int>(Graph::grid_height()) && !graph.passable(GridLocation(x, y + 1)));
+    };
+
+    std::vector<std::vector<Entry> > m_blocks;
+};
+
+#endif // REGION_BOUNDARIES_H
@@ -0,0 +1,158 @@
+#ifndef RESUMABLE_SEARCH_H
+#define RESUMABLE_SEARCH_H
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "search_workspace.h"
+#include "bucket_queue.h"
+
+// A* run a slice at a time over frames. The graph mustn't change meanwhile.
+template<typename Graph, typename OpenList=BucketQueue<int>, typename Recorder=SearchRecorder<>,
+         typename Heuristic=std::function<int(typename Graph::Node, typename Graph::Node)> >
+class ResumableSearch
+{
+public:
+    using Node = typename Graph::Node;
+
+    enum Status {
+        SEARCHING,
+        FOUND,
+        NOT_FOUND
+    };
+
+    ResumableSearch(const Graph& graph, Node start, Node goal, Heuristic heuristic)
+        : ResumableSearch(graph, start, std::vector<Node> {goal}, heuristic)
+    {};
+
+    // With several goals it searches from them towards start.
+    template<typename Goals>
+    ResumableSearch(const Graph& graph, Node start, const Goals& goals, Heuristic heuristic)
+        : m_graph(graph)
+        , m_start(start)
+        , m_goals(goals.begin(), goals.end())
+        , m_backward(m_goals.size() != 1)
+        , m_heuristic(heuristic)
+        , m_status(SEARCHING)
+        , m_expanded(0)
+    {
+        m_workspace.reset(Graph::size());
+        if (!m_backward) {
+            const NodeIndex start_idx = m_graph.index(start);
+            m_workspace.relax(start_idx, 0, start_idx);
+            m_workspace.frontier.put(start_idx, 0);
+        }
+        for (auto& goal : m_goals) {
+            if (m_backward && m_graph.in_bounds(goal) && m_graph.passable(goal)) {
+                const NodeIndex goal_idx = m_graph.index(goal);
+                m_workspace.relax(goal_idx, 0, goal_idx);
+                m_workspace.frontier.put(goal_idx, m_heuristic(goal, start));
+            }
+        }
+        m_workspace.stats.pause();
+    }
+
+    Node start() const { return m_start; };
+    const std::vector<Node>& goals() const { return m_goals; };
+    // Of several goals the one found.
+    Node goal() const { return m_backward ? m_found : m_goals.front(); };
+    Status status() const { return m_status; };
+    size_t expanded() const { return m_expanded; };
+    // Counted over all the steps, timed only while stepping.
+    SearchStats stats() const { return m_workspace.stats.stats(); };
+
+    // Expands at most max_expansions nodes. Returns how many it did.
+    size_t step(size_t max_expansions) {
+        auto& frontier = m_workspace.frontier;
+        const NodeIndex target_idx = m_graph.index(target());
+        size_t expansions = 0;
+        if (m_status == SEARCHING) {
+            m_workspace.stats.resume();
+        }
+        while (m_status == SEARCHING && expansions < max_expansions) {
+            if (frontier.empty()) {
+                m_status = NOT_FOUND;
+                m_workspace.stats.end(0);
+                break;
+            }
+            auto current = frontier.get();
+            m_workspace.stats.popped();
+            if (current == target_idx) {
+                m_status = FOUND;
+                m_found = m_graph.location(source(current));
+                m_workspace.stats.end(path_length());
+                break;
+            }
+
+            expansions++;
+            m_workspace.stats.expanded();
+            auto current_loc = m_graph.location(current);
+            m_graph.for_each_neighbor(current_loc, [&](const Node& next) {
+                NodeIndex next_idx = m_graph.index(next);
+                int new_cost = m_workspace.cost(current) + m_graph.cost(current_loc, next);
+                const bool reached = m_workspace.reached(next_idx);
+                if (!reached || new_cost < m_workspace.cost(next_idx)) {
+                    m_workspace.relax(next_idx, new_cost, current);
+                    frontier.put(next_idx, new_cost + m_heuristic(next, target()));
+                    m_workspace.stats.pushed(reached);
+                }
+            });
+        }
+        if (m_status == SEARCHING) {
+            m_workspace.stats.pause();
+        }
+        m_expanded += expansions;
+        return expansions;
+    };
+
+    // Empty unless the search has found the goal.
+    std::vector<Node> path() const {
+        std::vector<Node> path;
+        if (m_status != FOUND) {
+            return path;
+        }
+        // Every node came from the next one towards where the search began.
+        auto current = m_graph.index(target());
+        path.push_back(target());
+        while (m_workspace.came_from(current) != current) {
+            current = m_workspace.came_from(current);
+            path.push_back(m_graph.location(current));
+        }
+        if (!m_backward) {
+            std::reverse(path.begin(), path.end());
+        }
+        return path;
+    };
+
+private:
+    // Where the search is headed.
+    Node target() const { return m_backward ? m_start : m_goals.front(); };
+
+    NodeIndex source(NodeIndex current) const {
+        while (m_workspace.came_from(current) != current) {
+            current = m_workspace.came_from(current);
+        }
+        return current;
+    };
+
+    size_t path_length() const {
+        size_t length = 1;
+        for (auto current = m_graph.index(target()); m_workspace.came_from(current) != current;
+             current = m_workspace.came_from(current)) {
+            length++;
+        }
+        return length;
+    };
+
+    const Graph& m_graph;
+    const Node m_start;
+    const std::vector<Node> m_goals;
+    const bool m_backward;
+    Node m_found;
+    Heuristic m_heuristic;
+    Status m_status;
+    size_t m_expanded;
+    SearchWorkspace<int, OpenList, Recorder> m_workspace;
+};
+
+#endif // RESUMABLE_SEARCH_H
@@ -0,0 +1,95 @@
+#ifndef SEARCH_POOL_H
+#define SEARCH_POOL_H
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+// Worker threads running searches, each with a Workspace of its own.
+template<typename Workspace>
+class SearchPool
+{
+public:
+    using Job = std::function<void(Workspace&)>;
+
+    SearchPool(unsigned threads)
+        : m_running(0)
+        , m_paused(false)
+        , m_stopping(false)
+    {
+        for (unsigned worker = 0; worker < threads; worker++) {
+            m_workers.emplace_back([this]() { work(); });
+        }
+    };
+
+    // Runs the jobs still queued before the workers stop.
+    ~SearchPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_changed.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    };
+
+    size_t thread_count() const { return m_workers.size(); };
+
+    void submit(Job job) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(std::move(job));
+        }
+        m_changed.notify_one();
+    };
+
+    // Runs edit while no job runs, e.g. to change the graph.
+    template<typename Edit>
+    void exclusive(Edit edit) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_paused = true;
+        m_changed.wait(lock, [this]() { return m_running == 0; });
+        edit();
+        m_paused = false;
+        lock.unlock();
+        m_changed.notify_all();
+    }
+
+private:
+    void work() {
+        Workspace workspace;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_changed.wait(lock, [this]() { return m_stopping || (!m_paused && !m_jobs.empty()); });
+            if (m_jobs.empty()) {
+                return;
+            }
+            Job job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_running++;
+            lock.unlock();
+
+            job(workspace);
+
+            lock.lock();
+            m_running--;
+            if (m_paused && m_running == 0) {
+                m_changed.notify_all();
+            }
+        }
+    };
+
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::deque<Job> m_jobs;
+    unsigned m_running;
+    bool m_paused;
+    bool m_stopping;
+    std::vector<std::thread> m_workers;
+};
+
+#endif // SEARCH_POOL_H
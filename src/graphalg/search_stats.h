@@ -0,0 +1,83 @@
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <chrono>
+#include <cstddef>
+
+// Build with -DSEARCH_STATS=1 to have searches count their work.
+#ifndef SEARCH_STATS
+#define SEARCH_STATS 0
+#endif
+
+// What searches did, summed over any number of them.
+struct SearchStats {
+    size_t searches = 0;
+    size_t expanded = 0;
+    size_t pushes = 0;
+    size_t pops = 0;
+    size_t duplicates = 0; // pushes of nodes reached before
+    size_t path_length = 0; // tiles
+    double ms = 0;
+
+    SearchStats& operator+=(const SearchStats& other) {
+        searches += other.searches;
+        expanded += other.expanded;
+        pushes += other.pushes;
+        pops += other.pops;
+        duplicates += other.duplicates;
+        path_length += other.path_length;
+        ms += other.ms;
+        return *this;
+    };
+};
+
+// Counts the work of one search at a time.
+template<bool enabled = SEARCH_STATS>
+class SearchRecorder
+{
+public:
+    void begin() {
+        m_stats = SearchStats();
+        resume();
+    };
+    inline void expanded() { m_stats.expanded++; };
+    inline void pushed(bool duplicate) {
+        m_stats.pushes++;
+        m_stats.duplicates += duplicate ? 1 : 0;
+    };
+    inline void popped() { m_stats.pops++; };
+    void pause() {
+        m_stats.ms += std::chrono::duration<double, std::milli>(Clock::now() - m_resumed).count();
+    };
+    void resume() { m_resumed = Clock::now(); };
+    void end(size_t path_length) {
+        pause();
+        m_stats.searches = 1;
+        m_stats.path_length = path_length;
+    };
+
+    const SearchStats& stats() const { return m_stats; };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    SearchStats m_stats;
+    Clock::time_point m_resumed;
+};
+
+template<>
+class SearchRecorder<false>
+{
+public:
+    void begin() {};
+    inline void expanded() {};
+    inline void pushed(bool) {};
+    inline void popped() {};
+    void pause() {};
+    void resume() {};
+    void end(size_t) {};
+
+    SearchStats stats() const { return SearchStats(); };
+};
+
+#endif // SEARCH_STATS_H
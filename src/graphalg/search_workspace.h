@@ -0,0 +1,57 @@
+#ifndef SEARCH_WORKSPACE_H
+#define SEARCH_WORKSPACE_H
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include "priority_queue.h"
+#include "search_stats.h"
+
+using NodeIndex = uint32_t;
+
+// Per-node search state in flat arrays, stamped by generation so that
+// reset() is O(1).
+template<typename Number=int, typename OpenList=PriorityQueue<NodeIndex, Number>,
+         typename Recorder=SearchRecorder<> >
+class SearchWorkspace
+{
+public:
+    SearchWorkspace() : m_generation(0) {};
+
+    void reset(size_t size) {
+        if (m_stamp.size() < size) {
+            m_stamp.resize(size, 0);
+            m_cost.resize(size);
+            m_came_from.resize(size);
+        }
+        frontier.clear();
+        stats.begin();
+        m_generation++;
+        if (m_generation == 0) {
+            // The counter wrapped, so old stamps could look fresh again.
+            std::fill(m_stamp.begin(), m_stamp.end(), 0);
+            m_generation = 1;
+        }
+    };
+
+    inline bool reached(NodeIndex idx) const { return m_stamp[idx] == m_generation; };
+    inline Number cost(NodeIndex idx) const { return m_cost[idx]; };
+    inline NodeIndex came_from(NodeIndex idx) const { return m_came_from[idx]; };
+
+    inline void relax(NodeIndex idx, Number cost, NodeIndex parent) {
+        m_stamp[idx] = m_generation;
+        m_cost[idx] = cost;
+        m_came_from[idx] = parent;
+    };
+
+    OpenList frontier;
+    Recorder stats;
+
+private:
+    uint32_t m_generation;
+    std::vector<uint32_t> m_stamp;
+    std::vector<Number> m_cost;
+    std::vector<NodeIndex> m_came_from;
+};
+
+#endif // SEARCH_WORKSPACE_H
@@ -2,7 +2,8 @@
 #include "lifeform.h"
 #include "world.h"
 #include "worldposition.h"
-#include "commands/move_command.h"
+#include "commands/follow_path_command.h"
+#include "graphalg/coverage_tour.h"
 #include "gameconstants.h"
 
 const uint32_t LifeForm::width = 8;
@@ -13,6 +14,7 @@ LifeForm::LifeForm(std::weak_ptr<World> world, double pos_x, double pos_y)
     , m_pos_x(pos_x)
     , m_pos_y(pos_y)
     , m_focused(false)
+    , m_has_destination(false)
 {
     auto world_p = m_world.lock();
     if (!world_p) {
@@ -22,6 +24,14 @@ LifeForm::LifeForm(std::weak_ptr<World> world, double pos_x, double pos_y)
     m_visited_tiles.insert(world_p->location(get_pos()));
 }
 
+LifeForm::~LifeForm()
+{
+    auto world = m_world.lock();
+    if (world) {
+        world->end_order(this);
+    }
+}
+
 WorldPosition LifeForm::get_pos() const
 {
     return WorldPosition(m_pos_x, m_pos_y);
@@ -51,8 +61,132 @@ void LifeForm::patrol(const std::unordered_set<GridLocation>& locations)
         return;
     }
 
+    auto world = m_world.lock();
+    if (!world) {
+        return;
+    }
+
     m_visited_tiles.clear();
     m_unvisited_tiles = locations;
+    if (m_has_destination) {
+        m_has_destination = false;
+        world->end_order(this);
+    }
+    plan_patrol(*world);
+}
+
+void LifeForm::replan()
+{
+    auto world = m_world.lock();
+    if (!world) {
+        return;
+    }
+
+    if (m_patrol_plan) {
+        // What is queued of the tour may cross what changed.
+        plan_patrol(*world);
+        if (!m_has_destination) {
+            while (!m_commands.empty()) {
+                m_commands.pop();
+            }
+        }
+    }
+    if (!m_has_destination) {
+        return;
+    }
+
+    while (!m_commands.empty()) {
+        m_commands.pop();
+    }
+    int x, y;
+    std::tie(x, y) = m_destination;
+    move_along(world->get_path(this, get_pos(),
+                               WorldPosition(x * TILE_WIDTH + TILE_WIDTH/2,
+                                             y * TILE_HEIGHT + TILE_HEIGHT/2)));
+}
+
+void LifeForm::move_along(const CompactPath& path)
+{
+    if (!path.empty()) {
+        m_commands.emplace(new FollowPathCommand(this, path));
+    }
+}
+
+void LifeForm::plan_patrol(World& world)
+{
+    std::vector<GridLocation> tiles;
+    for (auto& tile : m_unvisited_tiles) {
+        if (world.passable(tile)) {
+            tiles.push_back(tile);
+        }
+    }
+    m_patrol_plan.reset(new CoveragePlan(tiles));
+    m_patrol_request.reset();
+    m_patrol_legs = std::queue<GridLocation>();
+}
+
+void LifeForm::continue_patrol(World& world)
+{
+    auto current_tile = world.location(get_pos());
+    if (m_unvisited_tiles.erase(current_tile)) {
+        m_visited_tiles.insert(current_tile);
+    }
+    if (m_unvisited_tiles.empty()) {
+        end_patrol(world);
+        return;
+    }
+
+    if (m_patrol_legs.empty()) {
+        if (!m_patrol_request) {
+            if (m_patrol_plan->done()) {
+                end_patrol(world);
+                return;
+            }
+            m_patrol_request = world.request_path(this, get_pos(), m_patrol_plan->entries());
+        }
+        if (!m_patrol_request->done()) {
+            return;
+        }
+        auto request = std::move(m_patrol_request);
+        if (request->path().empty()) {
+            // Whatever is left of the patrol area can't be reached from here.
+            end_patrol(world);
+            return;
+        }
+        auto sweep = CompactPath::from_waypoints(m_patrol_plan->sweep(request->path().end()));
+        if (!world.cooperative()) {
+            move_along(request->path());
+            move_along(sweep);
+            return;
+        }
+        auto add_leg = [this](const GridLocation& loc) { m_patrol_legs.push(loc); };
+        request->path().for_each_waypoint(add_leg);
+        sweep.for_each_waypoint(add_leg);
+    }
+
+    // A cooperative plan ends with its window, so legs get planned again.
+    while (!m_patrol_legs.empty() && m_patrol_legs.front() == current_tile) {
+        m_patrol_legs.pop();
+    }
+    if (!m_patrol_legs.empty()) {
+        int x, y;
+        std::tie(x, y) = m_patrol_legs.front();
+        move_along(world.get_path(this, get_pos(),
+                                  WorldPosition(x * TILE_WIDTH + TILE_WIDTH/2,
+                                                y * TILE_HEIGHT + TILE_HEIGHT/2)));
+        if (m_commands.empty()) {
+            m_patrol_legs.pop();
+        }
+    }
+}
+
+void LifeForm::end_patrol(World& world)
+{
+    m_unvisited_tiles.clear();
+    m_patrol_plan.reset();
+    m_patrol_request.reset();
+    m_patrol_legs = std::queue<GridLocation>();
+    world.end_order(this);
 }
 
 void LifeForm::handle_event(const SDL_Event &event)
@@ -71,7 +205,8 @@ void LifeForm::handle_event(const SDL_Event &event)
                            width, height);
             if (rect.contains(WorldPoint(event.button.x + viewport.x, event.button.y + viewport.y))) {
                 set_focused(true);
-            } else {
+            } else if (!(SDL_GetModState() & KMOD_SHIFT)) {
+                // Shift-clicks add to the selection.
                 set_focused(false);
             }
         } else if (focused() && event.button.button == SDL_BUTTON_RIGHT) {
@@ -79,10 +214,17 @@ void LifeForm::handle_event(const SDL_Event &event)
             while (!m_commands.empty()) {
                 m_commands.pop();
             }
+            m_patrol_request.reset();
+            m_patrol_legs = std::queue<GridLocation>();
             const WorldRect viewport(world->get_viewport());
-            for (auto pt : world->get_path(get_pos(), WorldPosition(event.button.x + viewport.x,
-                                                                 event.button.y + viewport.y))) {
-                m_commands.emplace(new MoveCommand(this, WorldPosition(pt.x, pt.y)));
+            const WorldPosition destination(event.button.x + viewport.x,
+                                            event.button.y + viewport.y);
+            m_has_destination = true;
+            m_destination = world->location(destination);
+            move_along(world->get_path(this, get_pos(), destination));
+            if (m_commands.empty()) {
+                m_has_destination = false;
+                world->end_order(this);
             }
         }
     }
@@ -90,26 +232,12 @@ void LifeForm::handle_event(const SDL_Event &event)
 
 void LifeForm::update(uint32_t elapsed)
 {
-    if (m_commands.empty() && !m_unvisited_tiles.empty()) {
+    if (m_commands.empty() && m_patrol_plan) {
         auto world = m_world.lock();
         if (!world) {
             return;
         }
-
-        auto current_tile = world->location(get_pos());
-        auto closest_tile = world->closest(current_tile, m_unvisited_tiles);
-        if (current_tile == closest_tile) {
-            m_unvisited_tiles.erase(current_tile);
-            m_visited_tiles.insert(current_tile);
-        } else {
-            int x, y;
-            std::tie(x, y) = closest_tile;
-            for (auto pt : world->get_path(get_pos(),
-                                           WorldPosition(x * TILE_WIDTH + TILE_WIDTH/2,
-                                                         y * TILE_HEIGHT + TILE_HEIGHT/2))) {
-                m_commands.emplace(new MoveCommand(this, WorldPosition(pt.x, pt.y)));
-            }
-        }
+        continue_patrol(*world);
     }
 
     if (m_commands.empty()) {
@@ -123,7 +251,18 @@ void LifeForm::update(uint32_t elapsed)
         if (command->done()) {
             m_commands.pop();
             if (m_commands.empty()) {
-                break;
+                // A cooperative plan ends where its window does.
+                auto world = m_world.lock();
+                if (m_has_destination && world && world->location(get_pos()) != m_destination) {
+                    replan();
+                }
+                if (m_commands.empty()) {
+                    if (m_has_destination && world) {
+                        world->end_order(this);
+                    }
+                    m_has_destination = false;
+                    break;
+                }
             }
             command = m_commands.front().get();
         }
@@ -6,8 +6,11 @@
 #include <unordered_set>
 #include "commands/command.h"
 #include "graphalg/gridlocation.h"
+#include "graphalg/compact_path.h"
 
 class World;
+class PathRequest;
+class CoveragePlan;
 struct WorldPosition;
 class SDL_Renderer;
 union SDL_Event;
@@ -15,6 +18,7 @@ union SDL_Event;
 class LifeForm {
 public:
     LifeForm(std::weak_ptr<World> world, double pos_x, double pos_y);
+    ~LifeForm();
 
     WorldPosition get_pos() const;
     void move_to(const WorldPosition &new_position);
@@ -22,6 +26,8 @@ public:
     bool focused() const { return m_focused; };
     void set_focused (bool focused) { m_focused = focused; };
     void patrol(const std::unordered_set<GridLocation>& locations);
+    // Plans the current order or patrol again.
+    void replan();
 
     void handle_event(const SDL_Event &event);
     void update(uint32_t elapsed);
@@ -31,13 +37,25 @@ public:
     static const uint32_t height;
 
 private:
+    void move_along(const CompactPath& path);
+    // Plans a sweep over the patrol tiles still to visit.
+    void plan_patrol(World& world);
+    // Takes the patrol on from where the agent is, a cell at a time.
+    void continue_patrol(World& world);
+    void end_patrol(World& world);
+
     std::weak_ptr<World> m_world;
     double m_pos_x;
     double m_pos_y;
     bool m_focused;
+    bool m_has_destination;
+    GridLocation m_destination;
     std::queue<std::unique_ptr<Command> > m_commands;
     std::unordered_set<GridLocation> m_visited_tiles;
     std::unordered_set<GridLocation> m_unvisited_tiles;
+    std::unique_ptr<CoveragePlan> m_patrol_plan; // null unless patrolling
+    std::shared_ptr<PathRequest> m_patrol_request; // the way to the next cell
+    std::queue<GridLocation> m_patrol_legs; // waypoints to plan one by one in cooperative mode
 };
 
 #endif // LIFEFORM_H
@@ -0,0 +1,27 @@
+#ifndef PATHREQUEST_H
+#define PATHREQUEST_H
+
+#include <atomic>
+#include "graphalg/compact_path.h"
+
+// Path World::request_path() is looking for. Dropping it cancels the search.
+class PathRequest
+{
+public:
+    PathRequest() : m_done(false), m_expanded(0) {};
+
+    bool done() const { return m_done; };
+    // Nodes searched so far.
+    size_t expanded() const { return m_expanded; };
+    // Empty if there is no path. Only complete once done.
+    const CompactPath& path() const { return m_path; };
+
+private:
+    friend class World;
+
+    std::atomic<bool> m_done;
+    std::atomic<size_t> m_expanded;
+    CompactPath m_path;
+};
+
+#endif // PATHREQUEST_H
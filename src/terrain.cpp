@@ -10,7 +10,13 @@ Terrain::Terrain(TerrainType type, SDL_Texture* texture)
 
 bool Terrain::passable() const
 {
-    return m_type == GRASS;
+    return m_type != WATER;
+}
+
+// Relative to grass, for passable terrain.
+uint8_t Terrain::move_cost() const
+{
+    return m_type == SHALLOW_WATER ? 3 : 1;
 }
 
 SDL_Texture * const Terrain::get_texture() const
@@ -9,12 +9,14 @@ class Terrain
 public:
     enum TerrainType {
         GRASS = 1,
-        WATER
+        WATER,
+        SHALLOW_WATER
     };
 
     Terrain(TerrainType type, SDL_Texture* texture);
 
     bool passable() const;
+    uint8_t move_cost() const;
     SDL_Texture * const get_texture() const;
 
 private:
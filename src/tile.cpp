@@ -19,6 +19,11 @@ bool Tile::passable() const
     return m_terrain->passable();
 }
 
+uint8_t Tile::move_cost() const
+{
+    return m_terrain->move_cost();
+}
+
 uint32_t Tile::region() const
 {
     return m_region;
@@ -30,7 +35,7 @@ void Tile::set_region(uint32_t reg)
     m_region = reg;
 }
 
-bool Tile::is_same_type(const Tile& other) const
+void Tile::clear_region()
 {
-    return m_terrain == other.m_terrain;
+    m_region = 0;
 }
@@ -11,11 +11,11 @@ public:
     Terrain* terrain() const;
 
     bool passable() const;
+    uint8_t move_cost() const;
 
     uint32_t region() const;
     void set_region(uint32_t reg);
-
-    bool is_same_type(const Tile& other) const;
+    void clear_region();
 
 private:
     Terrain* const m_terrain;
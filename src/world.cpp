@@ -1,7 +1,9 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <assert.h>
+#include <algorithm>
 #include <string>
+#include <thread>
 #include <vector>
 #include "worldposition.h"
 #include "world.h"
@@ -10,28 +12,38 @@
 #include "lifeform.h"
 #include "viewport.h"
 #include "graphalg/a_star_search.h"
+#include "graphalg/jump_point_search.h"
+#include "graphalg/bidirectional_search.h"
+#include "graphalg/any_angle.h"
+#include "graphalg/nearest_target.h"
 
 static uint32_t g_last_ticks = 0;
 static int g_fps = 0;
 
-using unique_surf = std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)>;
+// Time steps a cooperative plan looks ahead.
+static const uint32_t COOPERATIVE_WINDOW = 16;
+// Nodes request_path() searches may expand per frame, all together.
+static const size_t PATH_NODES_PER_FRAME = 1000;
+// Search time per frame worth a debug message, in ms.
+static const double SEARCH_MS_PER_FRAME = 4;
 
-inline int heuristic(GridLocation a, GridLocation b) {
-    int x1, y1, x2, y2;
-    std::tie(x1, y1) = a;
-    std::tie(x2, y2) = b;
-    return abs(x1 - x2) + abs(y1 + y2);
-}
+using unique_surf = std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)>;
 
 World::World(std::shared_ptr<SDL_Renderer> renderer)
     : m_renderer(renderer)
     , m_viewport(std::make_shared<Viewport>(WorldRect(0, 0, 640, 480)))
     , m_grass_terrain(nullptr)
     , m_water_terrain(nullptr)
+    , m_shallow_terrain(nullptr)
+    , m_path_search(JUMP_POINT)
+    , m_any_angle(true)
+    , m_cooperative(false)
+    , m_time(0)
     , m_texture(nullptr, SDL_DestroyTexture)
     , m_txt_rect(0, 0, 640 + TILE_WIDTH*4, 480 + TILE_HEIGHT*4)
     , m_selection_rect(0, 0, 0, 0)
     , m_mouse_down(false)
+    , m_path_workers(nullptr)
 {
     unique_surf temp_surf(IMG_Load("tileset.png"), SDL_FreeSurface);
     assert(temp_surf != nullptr);
@@ -48,9 +60,19 @@ World::World(std::shared_ptr<SDL_Renderer> renderer)
     SDL_BlitSurface(temp_surf.get(), &rect, grass_surf.get(), nullptr);
     rect.x = TILE_WIDTH * 1;
     SDL_BlitSurface(temp_surf.get(), &rect, water_surf.get(), nullptr);
+    unique_surf shallow_surf(SDL_CreateRGBSurface(0, TILE_WIDTH, TILE_HEIGHT,
+                                                  32, 0, 0, 0, 0),
+                             SDL_FreeSurface);
+    assert(shallow_surf != nullptr);
+    // Water over grass at half opacity
+    SDL_BlitSurface(grass_surf.get(), nullptr, shallow_surf.get(), nullptr);
+    SDL_SetSurfaceBlendMode(temp_surf.get(), SDL_BLENDMODE_BLEND);
+    SDL_SetSurfaceAlphaMod(temp_surf.get(), 128);
+    SDL_BlitSurface(temp_surf.get(), &rect, shallow_surf.get(), nullptr);
 
     m_grass_terrain.reset(new Terrain(Terrain::GRASS, SDL_CreateTextureFromSurface(m_renderer.get(), grass_surf.get())));
     m_water_terrain.reset(new Terrain(Terrain::WATER, SDL_CreateTextureFromSurface(m_renderer.get(), water_surf.get())));
+    m_shallow_terrain.reset(new Terrain(Terrain::SHALLOW_WATER, SDL_CreateTextureFromSurface(m_renderer.get(), shallow_surf.get())));
 
     m_tiles.load("world.map", [this](std::string token) -> std::unique_ptr<Tile> {
             switch (std::stoi(token)) {
@@ -62,10 +84,18 @@ World::World(std::shared_ptr<SDL_Renderer> renderer)
                 std::unique_ptr<Tile> water_tile(new Tile(m_water_terrain.get()));
                 return water_tile;
             }
+            case Terrain::SHALLOW_WATER: {
+                std::unique_ptr<Tile> shallow_tile(new Tile(m_shallow_terrain.get()));
+                return shallow_tile;
+            }
             default:
                 assert(false);
             }
     });
+    m_hierarchy.build(m_tiles);
+    m_landmarks.build(m_tiles);
+    m_region_boundaries.build(m_tiles);
+    set_path_workers(std::max(1u, std::thread::hardware_concurrency()) - 1);
 
     // Create world texture
     m_texture.reset(SDL_CreateTexture(m_renderer.get(), SDL_PIXELFORMAT_RGBA8888,
@@ -78,24 +108,134 @@ World::World(std::shared_ptr<SDL_Renderer> renderer)
 
 World::~World() {}
 
-std::vector<WorldPoint> World::get_path(const WorldPosition &start, const WorldPosition &end) const
+void World::set_path_search(PathSearch search)
+{
+    if (search == FIRST_MOVE_TABLE && !m_first_moves.built()) {
+        uint32_t started(SDL_GetTicks());
+        m_first_moves.build(m_tiles);
+        SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "first move table: %zu runs in %u ms",
+                     m_first_moves.run_count(), SDL_GetTicks() - started);
+    }
+    m_path_search = search;
+}
+
+void World::set_any_angle(bool any_angle)
+{
+    m_any_angle = any_angle;
+}
+
+void World::set_cooperative(bool cooperative)
+{
+    m_cooperative = cooperative;
+}
+
+bool World::cooperative() const
+{
+    return m_cooperative;
+}
+
+void World::set_path_workers(unsigned workers)
+{
+    m_path_workers.reset(workers ? new PathWorkers(workers) : nullptr);
+}
+
+CompactPath World::get_path(const LifeForm* agent, const WorldPosition &start, const WorldPosition &end) const
 {
     const auto current(location(start));
-    const auto goal(location(end));
+    auto goal(location(end));
+    if (!reachable_goal(current, goal)) {
+        return CompactPath();
+    }
 
-    int current_x, current_y, goal_x, goal_y;
-    std::tie(current_x, current_y) = current;
-    std::tie(goal_x, goal_y) = goal;
-    if (m_tiles.at(current_x, current_y)->region() ==
-            m_tiles.at(goal_x, goal_y)->region()) {
-        std::function<int(GridLocation, GridLocation)> h_func = heuristic;
-        auto path = a_star_search(m_tiles, current, goal, h_func);
-        auto wpath = as_world_path(path);
-        return wpath;
+    if (m_cooperative) {
+        return cooperative_path(agent, current, goal);
+    }
+    if (m_goals.assign(agent, goal) > 1 && (!m_flow_field.built() || m_flow_field.goal() != goal)) {
+        m_flow_field.build(m_tiles, goal);
+    }
+    if (m_flow_field.built() && m_flow_field.goal() == goal && m_flow_field.reaches(current)) {
+        auto path = m_flow_field.find_path(current);
+        return m_any_angle ? as_any_angle_path(path) : as_world_path(path);
+    }
+
+    std::vector<GridLocation> path;
+    auto planner = m_planners.find(agent);
+    if (planner != m_planners.end() && planner->second->goal() == goal) {
+        // The terrain changed during the order, repair the last search.
+        path = planner->second->find_path(current);
+        record_search(agent, planner->second->stats());
     } else {
-        std::vector<WorldPoint> empty_path;
-        return empty_path;
+        if (planner != m_planners.end()) {
+            m_planners.erase(planner);
+        }
+        path = search_path(agent, current, goal);
+    }
+    if (path.empty()) {
+        return CompactPath();
+    }
+    return m_any_angle ? as_any_angle_path(path) : as_world_path(path);
+}
+
+std::shared_ptr<PathRequest> World::request_path(const LifeForm* agent, const WorldPosition &start,
+                                                 const std::unordered_set<GridLocation>& goals)
+{
+    auto request = std::make_shared<PathRequest>();
+    const auto current(location(start));
+    CompactPath cached;
+    if (cached_path(current, goals, cached)) {
+        request->m_path = m_any_angle ? as_any_angle_path(cached.steps()) : cached;
+        request->m_done = true;
+        return request;
+    }
+
+    if (m_path_workers) {
+        auto h_func = heuristic();
+        const bool any_angle = m_any_angle;
+        m_path_workers->submit([this, agent, request, current, goals, h_func, any_angle](SearchWorkspace<int, BucketQueue<int> >& workspace) {
+            if (request.unique()) {
+                return; // nobody is waiting for it any more
+            }
+            auto path = path_to_nearest(m_tiles, current, goals, h_func, workspace);
+            record_search(agent, workspace.stats.stats());
+            if (!path.empty()) {
+                cache_path(current, path.back(), path);
+                request->m_path = any_angle ? as_any_angle_path(path) : as_world_path(path);
+            }
+            request->m_done = true;
+        });
+        return request;
     }
+
+    PendingPath pending;
+    pending.agent = agent;
+    pending.request = request;
+    pending.search.reset(new PendingSearch(m_tiles, current, goals, heuristic()));
+    m_pending_paths.push_back(std::move(pending));
+    return request;
+}
+
+size_t World::path_cache_hits() const
+{
+    std::lock_guard<std::mutex> lock(m_path_cache_mutex);
+    return m_path_cache.hits();
+}
+
+size_t World::path_cache_misses() const
+{
+    std::lock_guard<std::mutex> lock(m_path_cache_mutex);
+    return m_path_cache.misses();
+}
+
+SearchStats World::frame_search_stats() const
+{
+    return m_last_frame_stats;
+}
+
+SearchStats World::agent_search_stats(const LifeForm* agent) const
+{
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+    auto found = m_agent_stats.find(agent);
+    return found != m_agent_stats.end() ? found->second : SearchStats();
 }
 
 GridLocation World::location(const WorldPosition& pos) const
@@ -105,9 +245,9 @@ GridLocation World::location(const WorldPosition& pos) const
     return location;
 }
 
-GridLocation World::closest(const GridLocation& loc, const std::unordered_set<GridLocation>& locs) const
+bool World::passable(const GridLocation& loc) const
 {
-    return m_tiles.closest(loc, locs);
+    return m_tiles.in_bounds(loc) && m_tiles.passable(loc);
 }
 
 const WorldRect World::get_viewport() const
@@ -125,17 +265,92 @@ void World::add_entity(std::shared_ptr<LifeForm> entity)
     m_lifeforms.push_back(entity);
 }
 
+void World::end_order(const LifeForm* agent)
+{
+    m_planners.erase(agent);
+    m_reservations.release(agent);
+    m_goals.release(agent);
+}
+
+void World::toggle_terrain(const GridLocation& loc)
+{
+    for (auto entity : m_lifeforms) {
+        if (location(entity->get_pos()) == loc) {
+            // It would be stranded in water, with nowhere to go.
+            return;
+        }
+    }
+
+    int x, y;
+    std::tie(x, y) = loc;
+    // Grass, then shallow water, then water
+    Terrain* terrain = m_tiles.at(x, y)->terrain();
+    if (terrain == m_grass_terrain.get()) {
+        terrain = m_shallow_terrain.get();
+    } else if (terrain == m_shallow_terrain.get()) {
+        terrain = m_water_terrain.get();
+    } else {
+        terrain = m_grass_terrain.get();
+    }
+    auto edit = [&]() {
+        m_tiles.replace(x, y, std::unique_ptr<Tile>(new Tile(terrain)));
+        m_landmarks.build(m_tiles);
+        std::lock_guard<std::mutex> lock(m_path_cache_mutex);
+        m_path_cache.invalidate(loc, WorldGrid::Heuristic());
+    };
+    if (m_path_workers) {
+        // Searches in flight read all of it.
+        m_path_workers->exclusive(edit);
+    } else {
+        edit();
+    }
+
+    m_hierarchy.build(m_tiles);
+    m_region_boundaries.build(m_tiles);
+    if (m_first_moves.built()) {
+        m_first_moves.build(m_tiles);
+    }
+    for (auto& planner : m_planners) {
+        planner.second->notify_changed(loc);
+    }
+    // Orders under way are repaired incrementally from now on.
+    m_goals.for_each([this](const LifeForm* agent, const GridLocation& goal) {
+        auto& planner = m_planners[agent];
+        if (!planner) {
+            planner.reset(new DStarLite<WorldGrid>(m_tiles, goal));
+        }
+    });
+    if (m_flow_field.built()) {
+        m_flow_field.build(m_tiles, m_flow_field.goal());
+    }
+    for (auto& pending : m_pending_paths) {
+        pending.search.reset(new PendingSearch(m_tiles, pending.search->start(),
+                                               pending.search->goals(), heuristic()));
+    }
+    refresh_texture();
+
+    for (auto entity : m_lifeforms) {
+        entity->replan();
+    }
+}
+
 void World::handle_event(const SDL_Event &event)
 {
-    const uint8_t* current_key_states = SDL_GetKeyboardState(nullptr);
-    if (current_key_states[SDL_SCANCODE_UP]) {
-        m_viewport->move(WorldPoint(0, -1));
-    } else if (current_key_states[SDL_SCANCODE_DOWN]) {
-        m_viewport->move(WorldPoint(0, 1));
-    } else if (current_key_states[SDL_SCANCODE_LEFT]) {
-        m_viewport->move(WorldPoint(-1, 0));
-    } else if (current_key_states[SDL_SCANCODE_RIGHT]) {
-        m_viewport->move(WorldPoint(1, 0));
+    if (event.type == SDL_KEYDOWN && !event.key.repeat) {
+        // 1-6 pick the search, a/c toggle any-angle/cooperative, s logs stats.
+        const int32_t key = event.key.keysym.sym;
+        if (key >= SDLK_1 && key <= SDLK_6) {
+            set_path_search(static_cast<PathSearch>(key - SDLK_1));
+            SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "path search %d", key - SDLK_1 + 1);
+        } else if (key == SDLK_a) {
+            set_any_angle(!m_any_angle);
+            SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "any-angle moves %s", m_any_angle ? "on" : "off");
+        } else if (key == SDLK_c) {
+            set_cooperative(!m_cooperative);
+            SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "cooperative moves %s", m_cooperative ? "on" : "off");
+        } else if (key == SDLK_s) {
+            log_search_stats();
+        }
     }
 
     if (event.type == SDL_MOUSEBUTTONDOWN) {
@@ -144,6 +359,10 @@ void World::handle_event(const SDL_Event &event)
             m_selection_rect.x = event.button.x + vrect.x;
             m_selection_rect.y = event.button.y + vrect.y;
             m_mouse_down = true;
+        } else if (event.button.button == SDL_BUTTON_MIDDLE) {
+            WorldRect vrect = m_viewport->get_rect();
+            toggle_terrain(location(WorldPosition(event.button.x + vrect.x,
+                                                  event.button.y + vrect.y)));
         }
     } else if (event.type == SDL_MOUSEBUTTONUP) {
         if (event.button.button == SDL_BUTTON_LEFT) {
@@ -204,11 +423,49 @@ void World::handle_event(const SDL_Event &event)
 
 void World::update(uint32_t elapsed)
 {
+    const uint8_t* current_key_states = SDL_GetKeyboardState(nullptr);
+    if (current_key_states[SDL_SCANCODE_UP]) {
+        m_viewport->move(WorldPoint(0, -1));
+    } else if (current_key_states[SDL_SCANCODE_DOWN]) {
+        m_viewport->move(WorldPoint(0, 1));
+    } else if (current_key_states[SDL_SCANCODE_LEFT]) {
+        m_viewport->move(WorldPoint(-1, 0));
+    } else if (current_key_states[SDL_SCANCODE_RIGHT]) {
+        m_viewport->move(WorldPoint(1, 0));
+    }
+
+    m_time += elapsed;
+    search_pending_paths();
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        m_last_frame_stats = m_frame_stats;
+        m_frame_stats = SearchStats();
+    }
+    if (m_last_frame_stats.ms > SEARCH_MS_PER_FRAME) {
+        SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "%zu searches took %.1f ms, expanding %zu nodes",
+                     m_last_frame_stats.searches, m_last_frame_stats.ms, m_last_frame_stats.expanded);
+    }
     for (auto entity : m_lifeforms) {
         entity->update(elapsed);
     }
 }
 
+void World::log_search_stats() const
+{
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "path cache: %zu hits, %zu misses",
+                 path_cache_hits(), path_cache_misses());
+    const SearchStats frame(frame_search_stats());
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "last frame: %zu searches, %.1f ms, %zu nodes expanded",
+                 frame.searches, frame.ms, frame.expanded);
+    for (auto entity : m_lifeforms) {
+        if (entity->focused()) {
+            const SearchStats agent(agent_search_stats(entity.get()));
+            SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "lifeform %p: %zu searches, %.1f ms, %zu nodes expanded",
+                         static_cast<const void*>(entity.get()), agent.searches, agent.ms, agent.expanded);
+        }
+    }
+}
+
 void World::refresh_texture()
 {
     SDL_SetRenderTarget(m_renderer.get(), m_texture.get());
@@ -252,64 +509,6 @@ void World::refresh_texture()
     SDL_LogDebug(SDL_LOG_CATEGORY_RENDER, "vrect{%d, %d, %d, %d} m_txt_rect{%d, %d, %d, %d}", vrect.x, vrect.y, vrect.w, vrect.h, srect.x, srect.y, srect.w, srect.h);
 }
 
-std::vector<WorldPoint> World::as_world_path(const std::vector<GridLocation> &path) const
-{
-    std::vector<WorldPoint> result;
-    int current_x, current_y;
-    int dir = 0; // 1 - right, 2 - down, 3 - left, 4 - up
-    std::tie(current_x, current_y) = path.front();
-    result.emplace_back(current_x * TILE_WIDTH + TILE_WIDTH/2,
-                        current_y * TILE_HEIGHT + TILE_HEIGHT/2);
-    for (auto iter=path.begin() + 1; iter!= path.end(); ++iter) {
-        int pos_x, pos_y;
-        std::tie(pos_x, pos_y) = *iter;
-        if (pos_y == current_y && pos_x > current_x && dir != 1) {
-            if (dir == 2) {
-                result.emplace_back(pos_x * TILE_WIDTH - LifeForm::width/2,
-                                    pos_y * TILE_HEIGHT + LifeForm::height/2);
-            } else if (dir == 4) {
-                result.emplace_back((current_x + 1)* TILE_WIDTH - LifeForm::width/2,
-                                    (pos_y + 1) * TILE_HEIGHT - LifeForm::height/2);
-            }
-            dir = 1;
-        } else if (pos_x == current_x && pos_y > current_y && dir != 2) {
-            if (dir == 1) {
-                result.emplace_back(pos_x * TILE_WIDTH + LifeForm::width/2,
-                                    pos_y * TILE_HEIGHT - LifeForm::height/2);
-            } else if (dir == 3) {
-                result.emplace_back((pos_x + 1) * TILE_WIDTH - LifeForm::width/2,
-                                    pos_y * TILE_HEIGHT - LifeForm::height/2);
-            }
-            dir = 2;
-        } else if (pos_y == current_y && pos_x < current_x && dir != 3) {
-            if (dir == 2) {
-                result.emplace_back(current_x * TILE_WIDTH + LifeForm::width/2,
-                                    pos_y * TILE_HEIGHT + LifeForm::height/2);
-            } else if (dir == 4) {
-                result.emplace_back(current_x * TILE_WIDTH + LifeForm::width/2,
-                                    (pos_y + 1) * TILE_HEIGHT - LifeForm::height/2);
-            }
-            dir = 3;
-        } else if (pos_x == current_x && pos_y < current_y && dir != 4) {
-            if (dir == 1) {
-                result.emplace_back(pos_x * TILE_WIDTH + LifeForm::width/2,
-                                    current_y * TILE_HEIGHT + LifeForm::height/2);
-            } else if (dir == 3) {
-                result.emplace_back((pos_x + 1) * TILE_WIDTH - LifeForm::width/2,
-                                    current_y * TILE_HEIGHT + LifeForm::height/2);
-            }
-            dir = 4;
-        } else {
-            printf("Oops.\n");
-        }
-        current_x = pos_x; current_y = pos_y;
-    }
-    std::tie(current_x, current_y) = path.back();
-    result.emplace_back(current_x * TILE_WIDTH + TILE_WIDTH/2,
-                        current_y * TILE_HEIGHT + TILE_HEIGHT/2);
-    return result;
-}
-
 void World::render()
 {
     SDL_SetRenderDrawColor(m_renderer.get(), 0, 0, 0, 255);
@@ -352,3 +551,158 @@ void World::render()
         g_last_ticks = SDL_GetTicks();
     }
 }
+
+CompactPath World::as_world_path(const std::vector<GridLocation> &path) const
+{
+    // Each move ends where the path turns.
+    return CompactPath::from_waypoints(path);
+}
+
+CompactPath World::as_any_angle_path(const std::vector<GridLocation> &path) const
+{
+    // Shortcuts keep the whole sprite off the water, not just its center.
+    const double clearance = 0.5 * std::max(LifeForm::width, LifeForm::height) / TILE_WIDTH;
+    return CompactPath::from_waypoints(smooth_path(m_tiles, path, clearance));
+}
+
+std::vector<GridLocation> World::search_path(const LifeForm* agent, const GridLocation& start, const GridLocation& goal) const
+{
+    CompactPath cached;
+    if (cached_path(start, goal, cached)) {
+        return cached.steps();
+    }
+    auto h_func = heuristic();
+    std::vector<GridLocation> path;
+    switch (m_path_search) {
+    case JUMP_POINT:
+        path = jump_point_search(m_tiles, start, goal, h_func, m_search_workspace);
+        break;
+    case A_STAR:
+        path = a_star_search(m_tiles, start, goal, h_func, m_search_workspace);
+        break;
+    case BIDIRECTIONAL:
+    case BIDIRECTIONAL_PARALLEL:
+        path = bidirectional_search(m_tiles, start, goal, h_func,
+                                    m_search_workspace, m_backward_workspace,
+                                    m_path_search == BIDIRECTIONAL_PARALLEL);
+        break;
+    case HIERARCHICAL:
+        path = m_hierarchy.find_path(start, goal);
+        break;
+    case FIRST_MOVE_TABLE:
+        path = m_first_moves.find_path(start, goal);
+        break;
+    }
+    if (m_path_search != HIERARCHICAL && m_path_search != FIRST_MOVE_TABLE) {
+        SearchStats stats(m_search_workspace.stats.stats());
+        if (m_path_search == BIDIRECTIONAL || m_path_search == BIDIRECTIONAL_PARALLEL) {
+            stats += m_backward_workspace.stats.stats();
+        }
+        record_search(agent, stats);
+    }
+    cache_path(start, goal, path);
+    return path;
+}
+
+CompactPath World::cooperative_path(const LifeForm* agent, const GridLocation& start, const GridLocation& goal) const
+{
+    auto h_func = heuristic();
+    const uint32_t now = m_time / LIFEFORM_STEP_TIME;
+    m_reservations.release(agent);
+    auto steps = cooperative_search(m_tiles, start, goal, now, COOPERATIVE_WINDOW, h_func,
+                                    m_reservations, agent, m_search_workspace);
+    record_search(agent, m_search_workspace.stats.stats());
+    m_reservations.reserve(steps, now, now + COOPERATIVE_WINDOW, agent);
+
+    // Staying on a tile is a wait.
+    std::vector<GridLocation> path;
+    for (auto idx : steps) {
+        path.push_back(m_tiles.location(idx));
+    }
+    return CompactPath::from_waypoints(path);
+}
+
+void World::search_pending_paths()
+{
+    size_t budget = PATH_NODES_PER_FRAME;
+    while (!m_pending_paths.empty() && budget > 0) {
+        auto& pending = m_pending_paths.front();
+        if (pending.request.unique()) {
+            // Nobody is waiting for it any more.
+            m_pending_paths.pop_front();
+            continue;
+        }
+
+        budget -= pending.search->step(budget);
+        auto& request = *pending.request;
+        request.m_expanded = pending.search->expanded();
+        if (pending.search->status() != PendingSearch::SEARCHING) {
+            record_search(pending.agent, pending.search->stats());
+            auto path = pending.search->path();
+            if (!path.empty()) {
+                cache_path(pending.search->start(), pending.search->goal(), path);
+                request.m_path = m_any_angle ? as_any_angle_path(path) : as_world_path(path);
+            }
+            request.m_done = true;
+            m_pending_paths.pop_front();
+        }
+    }
+}
+
+WorldHeuristic World::heuristic() const
+{
+    return std::cref(m_landmarks);
+}
+
+bool World::reachable_goal(const GridLocation& start, GridLocation& goal) const
+{
+    int start_x, start_y, goal_x, goal_y;
+    std::tie(start_x, start_y) = start;
+    std::tie(goal_x, goal_y) = goal;
+    const uint32_t region = m_tiles.at(start_x, start_y)->region();
+    if (m_tiles.at(goal_x, goal_y)->region() == region) {
+        return true;
+    }
+    const GridLocation outside(goal);
+    return m_region_boundaries.closest(m_tiles, region, outside, goal);
+}
+
+bool World::cached_path(const GridLocation& start, const GridLocation& goal, CompactPath& path) const
+{
+    int x, y;
+    std::tie(x, y) = start;
+    std::lock_guard<std::mutex> lock(m_path_cache_mutex);
+    return m_path_cache.find(start, goal, m_tiles.at(x, y)->region(), path);
+}
+
+bool World::cached_path(const GridLocation& start, const std::unordered_set<GridLocation>& goals, CompactPath& path) const
+{
+    int x, y;
+    std::tie(x, y) = start;
+    std::lock_guard<std::mutex> lock(m_path_cache_mutex);
+    return m_path_cache.find_nearest(start, goals, m_tiles.at(x, y)->region(), WorldGrid::Heuristic(), path);
+}
+
+void World::cache_path(const GridLocation& start, const GridLocation& goal, const std::vector<GridLocation>& path) const
+{
+    int x, y;
+    std::tie(x, y) = start;
+    int cost = 0;
+    for (size_t i = 1; i < path.size(); i++) {
+        cost += m_tiles.cost(path[i - 1], path[i]);
+    }
+    std::lock_guard<std::mutex> lock(m_path_cache_mutex);
+    m_path_cache.insert(start, goal, m_tiles.at(x, y)->region(), CompactPath::from_waypoints(path), cost);
+}
+
+void World::record_search(const LifeForm* agent, const SearchStats& stats) const
+{
+    if (!SEARCH_STATS) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+    m_frame_stats += stats;
+    if (agent) {
+        m_agent_stats[agent] += stats;
+    }
+}
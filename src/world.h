@@ -1,10 +1,27 @@
 #ifndef WORLD_H
 #define WORLD_H
 
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include "worldpoint.h"
 #include "worldrect.h"
+#include "pathrequest.h"
 #include "graphalg/gridgraph.h"
+#include "graphalg/search_workspace.h"
+#include "graphalg/bucket_queue.h"
+#include "graphalg/hierarchical_graph.h"
+#include "graphalg/first_move_table.h"
+#include "graphalg/landmarks.h"
+#include "graphalg/d_star_lite.h"
+#include "graphalg/flow_field.h"
+#include "graphalg/cooperative_search.h"
+#include "graphalg/resumable_search.h"
+#include "graphalg/search_pool.h"
+#include "graphalg/path_cache.h"
+#include "graphalg/compact_path.h"
+#include "graphalg/region_boundaries.h"
 #include "gameconstants.h"
 
 class Viewport;
@@ -13,21 +30,53 @@ class Tile;
 class LifeForm;
 struct WorldPosition;
 
-using WorldGrid = GridGraph<Tile, WORLD_WIDTH, WORLD_HEIGHT>;
+using WorldGrid = GridGraph<Tile, WORLD_WIDTH, WORLD_HEIGHT, WORLD_CONNECTIVITY>;
+using WorldHeuristic = std::reference_wrapper<const LandmarkHeuristic<WorldGrid> >;
 
 class World
 {
 public:
+    enum PathSearch {
+        A_STAR,
+        JUMP_POINT,
+        BIDIRECTIONAL,
+        BIDIRECTIONAL_PARALLEL, // one thread per search direction
+        HIERARCHICAL,
+        FIRST_MOVE_TABLE // precomputed on first use
+    };
+
     World(std::shared_ptr<SDL_Renderer> renderer);
     virtual ~World();
 
-    std::vector<WorldPoint> get_path(const WorldPosition& start, const WorldPosition& end) const;
+    void set_path_search(PathSearch search);
+    // Walk straight between the turns of a path.
+    void set_any_angle(bool any_angle);
+    // Have lifeforms plan around each other's reserved moves.
+    void set_cooperative(bool cooperative);
+    bool cooperative() const;
+    // Threads for request_path(); with none it searches in update().
+    void set_path_workers(unsigned workers);
+
+    // Leads to the closest reachable tile if end can't be reached.
+    CompactPath get_path(const LifeForm* agent, const WorldPosition& start, const WorldPosition& end) const;
+    // Path to the nearest of goals, searched for in the background.
+    std::shared_ptr<PathRequest> request_path(const LifeForm* agent, const WorldPosition& start,
+                                              const std::unordered_set<GridLocation>& goals);
+    size_t path_cache_hits() const;
+    size_t path_cache_misses() const;
+    // Zero unless built with SEARCH_STATS.
+    SearchStats frame_search_stats() const;
+    SearchStats agent_search_stats(const LifeForm* agent) const;
     GridLocation location(const WorldPosition& pos) const;
-    GridLocation closest(const GridLocation& loc, const std::unordered_set<GridLocation>& locs) const;
+    bool passable(const GridLocation& loc) const;
     const WorldRect get_viewport() const;
     SDL_Rect to_sdl_rect(const WorldRect& rect) const;
 
     void add_entity(std::shared_ptr<LifeForm> entity);
+    // Drops agent's planner, reservations and goal.
+    void end_order(const LifeForm* agent);
+    // Does nothing under a lifeform.
+    void toggle_terrain(const GridLocation& loc);
 
     void handle_event(const SDL_Event &event);
     void update(uint32_t elapsed);
@@ -35,19 +84,63 @@ public:
 
 private:
 
+    using PathWorkers = SearchPool<SearchWorkspace<int, BucketQueue<int> > >;
+    using PendingSearch = ResumableSearch<WorldGrid, BucketQueue<int>, SearchRecorder<>, WorldHeuristic>;
+
+    struct PendingPath {
+        const LifeForm* agent;
+        std::shared_ptr<PathRequest> request;
+        std::unique_ptr<PendingSearch> search;
+    };
+
     void refresh_texture();
-    std::vector<WorldPoint> as_world_path(const std::vector<GridLocation> &path) const;
+    void log_search_stats() const;
+    void search_pending_paths();
+    WorldHeuristic heuristic() const;
+    // Moves goal into start's region. False if there is no tile to move to.
+    bool reachable_goal(const GridLocation& start, GridLocation& goal) const;
+    bool cached_path(const GridLocation& start, const GridLocation& goal, CompactPath& path) const;
+    bool cached_path(const GridLocation& start, const std::unordered_set<GridLocation>& goals, CompactPath& path) const;
+    void cache_path(const GridLocation& start, const GridLocation& goal, const std::vector<GridLocation>& path) const;
+    CompactPath as_world_path(const std::vector<GridLocation> &path) const;
+    CompactPath as_any_angle_path(const std::vector<GridLocation> &path) const;
+    std::vector<GridLocation> search_path(const LifeForm* agent, const GridLocation& start, const GridLocation& goal) const;
+    CompactPath cooperative_path(const LifeForm* agent, const GridLocation& start, const GridLocation& goal) const;
+    void record_search(const LifeForm* agent, const SearchStats& stats) const;
 
     std::shared_ptr<SDL_Renderer> m_renderer;
     std::shared_ptr<Viewport> m_viewport;
     std::vector<std::shared_ptr<LifeForm> > m_lifeforms;
     std::unique_ptr<Terrain> m_grass_terrain;
     std::unique_ptr<Terrain> m_water_terrain;
+    std::unique_ptr<Terrain> m_shallow_terrain;
     WorldGrid m_tiles;
+    mutable SearchWorkspace<int, BucketQueue<int> > m_search_workspace;
+    mutable SearchWorkspace<int, BucketQueue<int> > m_backward_workspace;
+    mutable HierarchicalGraph<WorldGrid> m_hierarchy;
+    FirstMoveTable<WorldGrid> m_first_moves;
+    LandmarkHeuristic<WorldGrid> m_landmarks;
+    RegionBoundaries<WorldGrid> m_region_boundaries;
+    mutable std::unordered_map<const LifeForm*, std::unique_ptr<DStarLite<WorldGrid> > > m_planners; // for orders the terrain changed under
+    mutable FlowField<WorldGrid> m_flow_field; // for the goal of the latest shared order
+    mutable SharedGoals<const LifeForm*> m_goals;
+    mutable ReservationTable<const LifeForm*> m_reservations;
+    std::deque<PendingPath> m_pending_paths;
+    mutable PathCache m_path_cache;
+    mutable std::mutex m_path_cache_mutex; // path workers use the cache too
+    mutable SearchStats m_frame_stats;
+    SearchStats m_last_frame_stats;
+    mutable std::unordered_map<const LifeForm*, SearchStats> m_agent_stats;
+    mutable std::mutex m_stats_mutex; // path workers record too
+    PathSearch m_path_search;
+    bool m_any_angle;
+    bool m_cooperative;
+    uint32_t m_time; // ms since start
     std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> m_texture;
     WorldRect m_txt_rect;
     WorldRect m_selection_rect; // Selected region in world coordinates
     bool m_mouse_down; // TODO: proper FSM is needed
+    std::unique_ptr<PathWorkers> m_path_workers; // stops first
 };
 
 #endif
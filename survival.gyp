@@ -31,6 +31,7 @@
                 'src/world.h',
                 'src/lifeform.cpp',
                 'src/lifeform.h',
+                'src/pathrequest.h',
                 'src/terrain.cpp',
                 'src/terrain.h',
                 'src/tile.cpp',
@@ -41,13 +42,36 @@
                 'src/worldposition.h',
                 'src/worldposition.cpp',
                 'src/graphalg/a_star_search.h',
+                'src/graphalg/bucket_queue.h',
                 'src/graphalg/gridgraph.h',
+                'src/graphalg/priority_queue.h',
+                'src/graphalg/search_workspace.h',
                 'src/graphalg/gridlocation.h',
                 'src/graphalg/gridlocation.cpp',
+                'src/graphalg/bidirectional_search.h',
+                'src/graphalg/any_angle.h',
+                'src/graphalg/flow_field.h',
+                'src/graphalg/cooperative_search.h',
+                'src/graphalg/resumable_search.h',
+                'src/graphalg/search_pool.h',
+                'src/graphalg/path_cache.h',
+                'src/graphalg/path_cache.cpp',
+                'src/graphalg/heuristics.h',
+                'src/graphalg/nearest_target.h',
+                'src/graphalg/coverage_tour.h',
+                'src/graphalg/bitboard.h',
+                'src/graphalg/compact_path.h',
+                'src/graphalg/search_stats.h',
+                'src/graphalg/region_boundaries.h',
+                'src/graphalg/d_star_lite.h',
+                'src/graphalg/landmarks.h',
+                'src/graphalg/first_move_table.h',
+                'src/graphalg/hierarchical_graph.h',
+                'src/graphalg/jump_point_search.h',
                 'src/commands/command.h',
                 'src/commands/command.cpp',
-                'src/commands/move_command.h',
-                'src/commands/move_command.cpp',
+                'src/commands/follow_path_command.h',
+                'src/commands/follow_path_command.cpp',
             ],
             'cflags': [
                 '<!@(<(pkg-config) --cflags sdl2)',
@@ -56,8 +80,10 @@
                 '-Wall',
                 '-pedantic',
                 '-g',
+                '-pthread',
             ],
             'ldflags': [
+                '-pthread',
             ],
             'libraries': [
                 '<!@(<(pkg-config) --libs-only-l sdl2)',
@@ -89,6 +115,97 @@
                 '<!@(<(pkg-config) --libs-only-l sdl2)',
             ]
         },
+        {
+            'target_name': 'tst_graphalg',
+            'type': 'executable',
+            'sources': [
+                'tests/tst_graphalg/tst_graphalg.cpp',
+                'src/graphalg/a_star_search.h',
+                'src/graphalg/bucket_queue.h',
+                'src/graphalg/gridgraph.h',
+                'src/graphalg/gridlocation.h',
+                'src/graphalg/gridlocation.cpp',
+                'src/graphalg/bidirectional_search.h',
+                'src/graphalg/any_angle.h',
+                'src/graphalg/flow_field.h',
+                'src/graphalg/cooperative_search.h',
+                'src/graphalg/resumable_search.h',
+                'src/graphalg/search_pool.h',
+                'src/graphalg/path_cache.h',
+                'src/graphalg/path_cache.cpp',
+                'src/graphalg/heuristics.h',
+                'src/graphalg/nearest_target.h',
+                'src/graphalg/coverage_tour.h',
+                'src/graphalg/bitboard.h',
+                'src/graphalg/compact_path.h',
+                'src/graphalg/search_stats.h',
+                'src/graphalg/region_boundaries.h',
+                'src/graphalg/d_star_lite.h',
+                'src/graphalg/landmarks.h',
+                'src/graphalg/first_move_table.h',
+                'src/graphalg/hierarchical_graph.h',
+                'src/graphalg/jump_point_search.h',
+                'src/graphalg/priority_queue.h',
+                'src/graphalg/search_workspace.h',
+            ],
+            'include_dirs': [
+                'src'
+            ],
+            'dependencies': [
+                'gtest'
+            ],
+            'cflags': [
+                '-std=c++11',
+                '-pedantic',
+                '-g',
+            ],
+        },
+        {
+            'target_name': 'bench_pathfinding',
+            'type': 'executable',
+            'sources': [
+                'benchmarks/bench_pathfinding/bench_pathfinding.cpp',
+                'src/graphalg/a_star_search.h',
+                'src/graphalg/bucket_queue.h',
+                'src/graphalg/gridgraph.h',
+                'src/graphalg/gridlocation.h',
+                'src/graphalg/gridlocation.cpp',
+                'src/graphalg/bidirectional_search.h',
+                'src/graphalg/any_angle.h',
+                'src/graphalg/flow_field.h',
+                'src/graphalg/cooperative_search.h',
+                'src/graphalg/resumable_search.h',
+                'src/graphalg/search_pool.h',
+                'src/graphalg/path_cache.h',
+                'src/graphalg/path_cache.cpp',
+                'src/graphalg/heuristics.h',
+                'src/graphalg/nearest_target.h',
+                'src/graphalg/coverage_tour.h',
+                'src/graphalg/bitboard.h',
+                'src/graphalg/compact_path.h',
+                'src/graphalg/search_stats.h',
+                'src/graphalg/region_boundaries.h',
+                'src/graphalg/d_star_lite.h',
+                'src/graphalg/landmarks.h',
+                'src/graphalg/first_move_table.h',
+                'src/graphalg/hierarchical_graph.h',
+                'src/graphalg/jump_point_search.h',
+                'src/graphalg/priority_queue.h',
+                'src/graphalg/search_workspace.h',
+            ],
+            'include_dirs': [
+                'src'
+            ],
+            'cflags': [
+                '-std=c++11',
+                '-O2',
+                '-g',
+                '-pthread',
+            ],
+            'ldflags': [
+                '-pthread',
+            ],
+        },
         {
             'target_name': 'gtest',
             'type': 'static_library',
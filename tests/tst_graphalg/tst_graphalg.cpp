@@ -0,0 +1,1189 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <sstream>
+#include "graphalg/gridgraph.h"
+#include "graphalg/a_star_search.h"
+#include "graphalg/jump_point_search.h"
+#include "graphalg/bidirectional_search.h"
+#include "graphalg/any_angle.h"
+#include "graphalg/flow_field.h"
+#include "graphalg/cooperative_search.h"
+#include "graphalg/resumable_search.h"
+#include "graphalg/search_pool.h"
+#include "graphalg/path_cache.h"
+#include "graphalg/compact_path.h"
+#include "graphalg/hierarchical_graph.h"
+#include "graphalg/first_move_table.h"
+#include "graphalg/landmarks.h"
+#include "graphalg/nearest_target.h"
+#include "graphalg/coverage_tour.h"
+#include "graphalg/bitboard.h"
+#include "graphalg/d_star_lite.h"
+#include "graphalg/search_stats.h"
+#include "graphalg/region_boundaries.h"
+
+class TestNode {
+public:
+    TestNode(bool passable, uint8_t move_cost = 1) : m_passable(passable), m_move_cost(move_cost), m_region(0) {};
+
+    bool passable() const { return m_passable; };
+    uint8_t move_cost() const { return m_move_cost; };
+    uint32_t region() const { return m_region; };
+    void set_region(uint32_t reg) { m_region = reg; };
+    void clear_region() { m_region = 0; };
+
+private:
+    bool m_passable;
+    uint8_t m_move_cost;
+    uint32_t m_region;
+};
+
+// Map tokens follow world.map: 1 is grass, 2 is water, 3 is shallow water.
+template<typename Graph>
+void load_map(Graph& graph, const std::string& map)
+{
+    std::istringstream stream(map);
+    graph.load(stream, [](std::string token) -> std::unique_ptr<TestNode> {
+        std::unique_ptr<TestNode> node(new TestNode(token != "2", token == "3" ? 3 : 1));
+        return node;
+    });
+}
+
+int manhattan(GridLocation a, GridLocation b)
+{
+    int x1, y1, x2, y2;
+    std::tie(x1, y1) = a;
+    std::tie(x2, y2) = b;
+    return abs(x1 - x2) + abs(y1 - y2);
+}
+
+// Random grass/water map with the given share of water tiles.
+std::string random_map(size_t width, size_t height, double water, unsigned seed, double shallow = 0)
+{
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution is_water(water), is_shallow(shallow);
+    std::string map;
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            map += is_water(rng) ? "2" : (shallow > 0 && is_shallow(rng) ? "3" : "1");
+            map += x + 1 < width ? " " : "\n";
+        }
+    }
+    return map;
+}
+
+// Checks the path is made of passable, 4-adjacent steps.
+template<typename Graph>
+void expect_valid_path(const Graph& graph, const std::vector<GridLocation>& path)
+{
+    for (size_t i = 0; i < path.size(); i++) {
+        EXPECT_TRUE(graph.in_bounds(path[i]) && graph.passable(path[i]));
+        if (i > 0) {
+            EXPECT_EQ(1, manhattan(path[i - 1], path[i]));
+        }
+    }
+}
+
+const char* const WALL_MAP =
+    "1 1 1 1 1\n"
+    "1 2 2 2 1\n"
+    "1 1 1 2 1\n"
+    "2 2 1 2 1\n"
+    "1 1 1 2 1\n";
+
+TEST(AStarSearchTest, FindsShortestPath) {
+    GridGraph<TestNode, 5, 5> graph;
+    load_map(graph, WALL_MAP);
+
+    auto path = a_star_search(graph, GridLocation(0, 4), GridLocation(4, 4), manhattan);
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(GridLocation(0, 4), path.front());
+    EXPECT_EQ(GridLocation(4, 4), path.back());
+    EXPECT_EQ(17u, path.size());
+}
+
+TEST(AStarSearchTest, UnreachableGoalGivesEmptyPath) {
+    GridGraph<TestNode, 5, 5> graph;
+    load_map(graph, WALL_MAP);
+
+    auto path = a_star_search(graph, GridLocation(0, 0), GridLocation(1, 1), manhattan);
+    EXPECT_TRUE(path.empty());
+}
+
+TEST(AStarSearchTest, ReusedWorkspaceGivesSamePaths) {
+    GridGraph<TestNode, 5, 5> graph;
+    load_map(graph, WALL_MAP);
+    SearchWorkspace<int> workspace;
+
+    auto first = a_star_search(graph, GridLocation(0, 4), GridLocation(4, 4), manhattan, workspace);
+    auto second = a_star_search(graph, GridLocation(2, 2), GridLocation(0, 0), manhattan, workspace);
+    auto third = a_star_search(graph, GridLocation(0, 4), GridLocation(4, 4), manhattan, workspace);
+    EXPECT_EQ(first, third);
+    EXPECT_EQ(5u, second.size());
+}
+
+TEST(GridGraphTest, IndexesNonSquareGrids) {
+    GridGraph<TestNode, 4, 2> graph;
+    load_map(graph, "1 1 1 2\n1 2 1 1\n");
+
+    EXPECT_EQ(8u, graph.size());
+    EXPECT_EQ(6u, graph.index(GridLocation(2, 1)));
+    EXPECT_EQ(GridLocation(3, 1), graph.location(7));
+    EXPECT_FALSE(graph.at(3, 0)->passable());
+    EXPECT_FALSE(graph.at(1, 1)->passable());
+}
+
+TEST(GridGraphTest, VisitsPassableNeighborsWithinBounds) {
+    GridGraph<TestNode, 4, 2> graph;
+    load_map(graph, "1 1 1 2\n1 2 1 1\n");
+
+    std::vector<GridLocation> corner;
+    graph.for_each_neighbor(GridLocation(0, 0), [&](const GridLocation& next) { corner.push_back(next); });
+    EXPECT_EQ(std::vector<GridLocation>({GridLocation(1, 0), GridLocation(0, 1)}), corner);
+
+    std::vector<NodeIndex> edge;
+    graph.for_each_neighbor(graph.index(GridLocation(3, 1)), [&](NodeIndex next) { edge.push_back(next); });
+    EXPECT_EQ(std::vector<NodeIndex>({graph.index(GridLocation(2, 1))}), edge);
+
+    EXPECT_FALSE(graph.passable(GridLocation(-1, 0)));
+    EXPECT_FALSE(graph.passable(GridLocation(4, 1)));
+    EXPECT_FALSE(graph.passable(GridLocation(2, 2)));
+}
+
+TEST(BucketQueueTest, PopsInPriorityOrder) {
+    BucketQueue<int> queue;
+    queue.put(3, 7);
+    queue.put(1, 2);
+    queue.put(2, 300); // wider than the initial ring
+    queue.put(0, 5);
+
+    EXPECT_EQ(1u, queue.get());
+    EXPECT_EQ(0u, queue.get());
+    EXPECT_EQ(3u, queue.get());
+    EXPECT_EQ(2u, queue.get());
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(BucketQueueTest, KeepsOneEntryPerNode) {
+    BucketQueue<int> queue;
+    queue.put(4, 10);
+    queue.put(5, 8);
+    queue.put(4, 6);  // decrease
+    queue.put(5, 12); // worse priority is ignored
+
+    EXPECT_EQ(4u, queue.get());
+    EXPECT_EQ(5u, queue.get());
+    EXPECT_TRUE(queue.empty());
+
+    queue.put(4, 1);
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+    queue.put(4, 3);
+    EXPECT_EQ(4u, queue.get());
+}
+
+TEST(AStarSearchTest, BucketQueueFindsSamePathLength) {
+    GridGraph<TestNode, 5, 5> graph;
+    load_map(graph, WALL_MAP);
+
+    auto heap_path = a_star_search(graph, GridLocation(0, 4), GridLocation(4, 4), manhattan);
+    auto bucket_path = a_star_search<BucketQueue<int> >(graph, GridLocation(0, 4), GridLocation(4, 4), manhattan);
+    EXPECT_EQ(heap_path.size(), bucket_path.size());
+    EXPECT_EQ(GridLocation(4, 4), bucket_path.back());
+}
+
+TEST(JumpPointSearchTest, MatchesAStarPathLengths) {
+    using Graph = GridGraph<TestNode, 24, 24>;
+    std::unique_ptr<Graph> graph(new Graph);
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> coord(0, 23);
+
+    for (unsigned seed = 0; seed < 10; seed++) {
+        load_map(*graph, random_map(24, 24, 0.3, seed));
+        for (int query = 0; query < 30; query++) {
+            GridLocation start(coord(rng), coord(rng)), goal(coord(rng), coord(rng));
+            if (!graph->passable(start) || !graph->passable(goal)) {
+                continue;
+            }
+            auto expected = a_star_search(*graph, start, goal, manhattan, workspace);
+            auto path = jump_point_search(*graph, start, goal, manhattan, workspace);
+            ASSERT_EQ(expected.size(), path.size());
+            if (!path.empty()) {
+                EXPECT_EQ(start, path.front());
+                EXPECT_EQ(goal, path.back());
+                expect_valid_path(*graph, path);
+            }
+        }
+    }
+}
+
+TEST(BidirectionalSearchTest, MatchesAStarPathLengths) {
+    using Graph = GridGraph<TestNode, 24, 24>;
+    std::unique_ptr<Graph> graph(new Graph);
+    SearchWorkspace<int, BucketQueue<int> > workspace, forward, backward;
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> coord(0, 23);
+
+    for (unsigned seed = 0; seed < 10; seed++) {
+        load_map(*graph, random_map(24, 24, 0.3, seed));
+        for (int query = 0; query < 30; query++) {
+            GridLocation start(coord(rng), coord(rng)), goal(coord(rng), coord(rng));
+            if (!graph->passable(start) || !graph->passable(goal)) {
+                continue;
+            }
+            auto expected = a_star_search(*graph, start, goal, manhattan, workspace);
+            for (bool parallel : {false, true}) {
+                auto path = bidirectional_search(*graph, start, goal, manhattan, forward, backward, parallel);
+                ASSERT_EQ(expected.size(), path.size());
+                if (!path.empty()) {
+                    EXPECT_EQ(start, path.front());
+                    EXPECT_EQ(goal, path.back());
+                    expect_valid_path(*graph, path);
+                }
+            }
+        }
+    }
+}
+
+TEST(AnyAngleTest, LineOfSightDoesNotCutCorners) {
+    GridGraph<TestNode, 5, 5> graph;
+    load_map(graph, WALL_MAP);
+
+    EXPECT_TRUE(line_of_sight(graph, GridLocation(0, 0), GridLocation(4, 0)));
+    EXPECT_TRUE(line_of_sight(graph, GridLocation(2, 2), GridLocation(2, 4)));
+    EXPECT_FALSE(line_of_sight(graph, GridLocation(0, 0), GridLocation(4, 4)));
+    // Passes between (2, 2) and the water at (1, 3) through their corner.
+    EXPECT_FALSE(line_of_sight(graph, GridLocation(1, 2), GridLocation(2, 3)));
+    EXPECT_FALSE(line_of_sight(graph, GridLocation(2, 3), GridLocation(1, 2)));
+}
+
+TEST(AnyAngleTest, LineOfSightKeepsClearance) {
+    GridGraph<TestNode, 5, 2> graph;
+    load_map(graph, "1 1 1 1 1\n"
+                    "1 2 1 1 1\n");
+
+    // The segment passes the water, a quarter tile square around it doesn't.
+    EXPECT_TRUE(line_of_sight(graph, GridLocation(0, 0), GridLocation(4, 1)));
+    EXPECT_FALSE(line_of_sight(graph, GridLocation(0, 0), GridLocation(4, 1), 0.25));
+    EXPECT_TRUE(line_of_sight(graph, GridLocation(0, 0), GridLocation(4, 0), 0.25));
+
+    auto path = a_star_search(graph, GridLocation(0, 0), GridLocation(4, 1), manhattan);
+    EXPECT_EQ(2u, smooth_path(graph, path).size());
+    auto smoothed = smooth_path(graph, path, 0.25);
+    ASSERT_LT(2u, smoothed.size());
+    for (size_t i = 1; i < smoothed.size(); i++) {
+        EXPECT_TRUE(line_of_sight(graph, smoothed[i - 1], smoothed[i], 0.25));
+    }
+}
+
+TEST(AnyAngleTest, SmoothedPathKeepsOnlyTurns) {
+    GridGraph<TestNode, 5, 5> graph;
+    load_map(graph, WALL_MAP);
+
+    auto path = a_star_search(graph, GridLocation(0, 4), GridLocation(4, 4), manhattan);
+    auto smoothed = smooth_path(graph, path);
+    std::vector<GridLocation> expected {
+        GridLocation(0, 4), GridLocation(2, 4), GridLocation(2, 2), GridLocation(0, 2),
+        GridLocation(0, 0), GridLocation(4, 0), GridLocation(4, 4)
+    };
+    EXPECT_EQ(expected, smoothed);
+
+    load_map(graph, random_map(5, 5, 0, 0));
+    path = a_star_search(graph, GridLocation(0, 4), GridLocation(4, 0), manhattan);
+    ASSERT_EQ(9u, path.size());
+    EXPECT_EQ(2u, smooth_path(graph, path).size());
+}
+
+TEST(FlowFieldTest, LeadsEveryReachableTileAlongShortestPaths) {
+    using Graph = GridGraph<TestNode, 24, 24>;
+    std::unique_ptr<Graph> graph(new Graph);
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+    FlowField<Graph> field;
+
+    for (unsigned seed = 0; seed < 5; seed++) {
+        load_map(*graph, random_map(24, 24, 0.3, seed));
+        GridLocation goal(12, 12);
+        field.build(*graph, goal);
+        for (NodeIndex idx = 0; idx < Graph::size(); idx++) {
+            auto start = graph->location(idx);
+            if (!graph->passable(start)) {
+                EXPECT_FALSE(field.reaches(start));
+                continue;
+            }
+            auto expected = a_star_search(*graph, start, goal, manhattan, workspace);
+            auto path = field.find_path(start);
+            ASSERT_EQ(expected.size(), path.size());
+            EXPECT_EQ(!path.empty(), field.reaches(start));
+            if (!path.empty()) {
+                EXPECT_EQ(start, path.front());
+                EXPECT_EQ(goal, path.back());
+                expect_valid_path(*graph, path);
+            }
+        }
+    }
+}
+
+TEST(FlowFieldTest, SecondAgentOnAGoalSharesIt) {
+    SharedGoals<int> goals;
+    GridLocation goal(3, 4), other(5, 5);
+
+    EXPECT_EQ(1u, goals.assign(1, goal));
+    EXPECT_EQ(1u, goals.assign(1, goal)); // replanning the same order
+    EXPECT_EQ(2u, goals.assign(2, goal));
+    EXPECT_EQ(1u, goals.assign(3, other));
+
+    // A new order leaves the old goal.
+    EXPECT_EQ(2u, goals.assign(2, other));
+    EXPECT_EQ(1u, goals.agents(goal));
+    goals.release(1);
+    goals.release(1);
+    EXPECT_EQ(0u, goals.agents(goal));
+    EXPECT_EQ(2u, goals.agents(other));
+    EXPECT_EQ(1u, goals.assign(1, goal));
+}
+
+TEST(CooperativeSearchTest, AgentsNeverShareTilesOrSwap) {
+    // Diagonal moves are possible, but take longer than a step.
+    using Graph = GridGraph<TestNode, 24, 24, 8>;
+    std::unique_ptr<Graph> graph(new Graph);
+    load_map(*graph, random_map(24, 24, 0.2, 3));
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+    ReservationTable<int> reservations;
+    const uint32_t window = 16;
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> coord(0, 23);
+
+    std::vector<std::vector<NodeIndex> > plans;
+    std::unordered_set<GridLocation> starts;
+    while (plans.size() < 20) {
+        GridLocation start(coord(rng), coord(rng)), goal(coord(rng), coord(rng));
+        if (!graph->passable(start) || !graph->passable(goal) || starts.count(start) ||
+                graph->at(std::get<0>(start), std::get<1>(start))->region() !=
+                graph->at(std::get<0>(goal), std::get<1>(goal))->region()) {
+            continue;
+        }
+        starts.insert(start);
+        int agent = plans.size();
+        auto plan = cooperative_search(*graph, start, goal, 100, window, Graph::Heuristic(),
+                                       reservations, agent, workspace);
+        ASSERT_FALSE(plan.empty());
+        EXPECT_EQ(graph->index(start), plan.front());
+        reservations.reserve(plan, 100, 100 + window, agent);
+        plans.push_back(plan);
+    }
+
+    auto at = [](const std::vector<NodeIndex>& plan, size_t step) {
+        return plan[std::min(step, plan.size() - 1)];
+    };
+    for (size_t a = 0; a < plans.size(); a++) {
+        for (size_t step = 1; step < plans[a].size(); step++) {
+            EXPECT_GE(1, manhattan(graph->location(plans[a][step - 1]), graph->location(plans[a][step])));
+        }
+        for (size_t b = a + 1; b < plans.size(); b++) {
+            for (size_t step = 0; step <= window; step++) {
+                EXPECT_NE(at(plans[a], step), at(plans[b], step));
+                if (step > 0) {
+                    EXPECT_FALSE(at(plans[a], step - 1) == at(plans[b], step) &&
+                                 at(plans[b], step - 1) == at(plans[a], step));
+                }
+            }
+        }
+    }
+}
+
+TEST(ResumableSearchTest, FindsSamePathsInSlices) {
+    using Graph = GridGraph<TestNode, 24, 24>;
+    using Search = ResumableSearch<Graph>;
+    std::unique_ptr<Graph> graph(new Graph);
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+    std::mt19937 rng(13);
+    std::uniform_int_distribution<int> coord(0, 23);
+
+    for (unsigned seed = 0; seed < 10; seed++) {
+        load_map(*graph, random_map(24, 24, 0.3, seed));
+        for (int query = 0; query < 30; query++) {
+            GridLocation start(coord(rng), coord(rng)), goal(coord(rng), coord(rng));
+            if (!graph->passable(start) || !graph->passable(goal)) {
+                continue;
+            }
+            Search search(*graph, start, goal, manhattan);
+            size_t expanded = 0;
+            while (search.status() == Search::SEARCHING) {
+                size_t step = search.step(7);
+                EXPECT_GE(7u, step);
+                expanded += step;
+            }
+            EXPECT_EQ(expanded, search.expanded());
+
+            auto expected = a_star_search(*graph, start, goal, manhattan, workspace);
+            EXPECT_EQ(expected.empty() ? Search::NOT_FOUND : Search::FOUND, search.status());
+            ASSERT_EQ(expected.size(), search.path().size());
+            if (!expected.empty()) {
+                expect_valid_path(*graph, search.path());
+            }
+        }
+    }
+}
+
+TEST(SearchPoolTest, RunsSearchesOnWorkersAndPausesForEdits) {
+    using Graph = GridGraph<TestNode, 24, 24>;
+    using Workspace = SearchWorkspace<int, BucketQueue<int> >;
+    std::unique_ptr<Graph> graph(new Graph);
+    load_map(*graph, random_map(24, 24, 0.3, 1));
+    std::vector<std::pair<GridLocation, GridLocation> > queries;
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> coord(0, 23);
+    for (int query = 0; query < 200; query++) {
+        queries.emplace_back(GridLocation(coord(rng), coord(rng)), GridLocation(coord(rng), coord(rng)));
+    }
+
+    std::vector<size_t> lengths(queries.size());
+    std::atomic<int> running(0);
+    std::atomic<bool> overlapped(false);
+    {
+        SearchPool<Workspace> pool(4);
+        EXPECT_EQ(4u, pool.thread_count());
+        for (size_t i = 0; i < queries.size(); i++) {
+            pool.submit([&, i](Workspace& workspace) {
+                running++;
+                lengths[i] = a_star_search(*graph, queries[i].first, queries[i].second, manhattan, workspace).size();
+                running--;
+            });
+            if (i == queries.size() / 2) {
+                pool.exclusive([&]() { overlapped = running != 0; });
+            }
+        }
+    } // runs the rest of the queue
+
+    EXPECT_FALSE(overlapped);
+    Workspace workspace;
+    for (size_t i = 0; i < queries.size(); i++) {
+        EXPECT_EQ(a_star_search(*graph, queries[i].first, queries[i].second, manhattan, workspace).size(), lengths[i]);
+    }
+}
+
+// Checks the path only makes moves the graph allows and returns its cost.
+template<typename Graph>
+int path_cost(const Graph& graph, const std::vector<GridLocation>& path)
+{
+    int cost = 0;
+    for (size_t i = 0; i < path.size(); i++) {
+        EXPECT_TRUE(graph.in_bounds(path[i]) && graph.passable(path[i]));
+        if (i > 0) {
+            bool neighbor = false;
+            graph.for_each_neighbor(path[i - 1], [&](const GridLocation& next) { neighbor |= next == path[i]; });
+            EXPECT_TRUE(neighbor);
+            cost += graph.cost(path[i - 1], path[i]);
+        }
+    }
+    return cost;
+}
+
+TEST(PathCacheTest, StoresEvictsAndInvalidatesPaths) {
+    GridGraph<TestNode, 5, 5> graph;
+    load_map(graph, WALL_MAP);
+    auto path = CompactPath::from_waypoints(a_star_search(graph, GridLocation(0, 4), GridLocation(4, 4), manhattan));
+    auto short_path = CompactPath::from_waypoints(a_star_search(graph, GridLocation(0, 0), GridLocation(2, 0), manhattan));
+
+    PathCache cache(2);
+    CompactPath found;
+    EXPECT_FALSE(cache.find(GridLocation(0, 4), GridLocation(4, 4), 1, found));
+    cache.insert(GridLocation(0, 4), GridLocation(4, 4), 1, path, path.steps().size() - 1);
+    EXPECT_FALSE(cache.find(GridLocation(0, 4), GridLocation(4, 4), 2, found));
+    ASSERT_TRUE(cache.find(GridLocation(0, 4), GridLocation(4, 4), 1, found));
+    EXPECT_EQ(path.steps(), found.steps());
+    EXPECT_EQ(1u, cache.hits());
+    EXPECT_EQ(2u, cache.misses());
+
+    // The least recently used one makes room.
+    cache.insert(GridLocation(0, 0), GridLocation(2, 0), 1, short_path, 2);
+    cache.find(GridLocation(0, 4), GridLocation(4, 4), 1, found);
+    cache.insert(GridLocation(2, 0), GridLocation(0, 0), 1, CompactPath::from_waypoints({GridLocation(2, 0), GridLocation(0, 0)}), 2);
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_FALSE(cache.find(GridLocation(0, 0), GridLocation(2, 0), 1, found));
+
+    // Far from the short path, but on the long one.
+    cache.invalidate(GridLocation(4, 2), manhattan);
+    EXPECT_FALSE(cache.find(GridLocation(0, 4), GridLocation(4, 4), 1, found));
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_TRUE(cache.find(GridLocation(2, 0), GridLocation(0, 0), 1, found));
+    // A straight path can't get any shorter.
+    cache.invalidate(GridLocation(1, 1), manhattan);
+    EXPECT_EQ(1u, cache.size());
+    cache.invalidate(GridLocation(1, 0), manhattan);
+    EXPECT_EQ(0u, cache.size());
+
+    // Through shallow water the path costs more than its length, so a
+    // detour that is longer may still be no costlier.
+    GridGraph<TestNode, 5, 3> shallow;
+    load_map(shallow, "1 1 1 1 1\n2 3 3 3 2\n1 1 1 1 1\n");
+    auto steps = a_star_search(shallow, GridLocation(0, 0), GridLocation(0, 2), manhattan);
+    ASSERT_EQ(6, path_cost(shallow, steps));
+    cache.insert(GridLocation(0, 0), GridLocation(0, 2), 1, CompactPath::from_waypoints(steps), 6);
+    cache.invalidate(GridLocation(2, 1), manhattan);
+    EXPECT_FALSE(cache.find(GridLocation(0, 0), GridLocation(0, 2), 1, found));
+
+    // A cached path answers for several goals if no other one can be nearer.
+    cache.insert(GridLocation(0, 0), GridLocation(2, 0), 1, short_path, 2);
+    std::unordered_set<GridLocation> goals {GridLocation(2, 0), GridLocation(4, 4)};
+    ASSERT_TRUE(cache.find_nearest(GridLocation(0, 0), goals, 1, manhattan, found));
+    EXPECT_EQ(short_path.steps(), found.steps());
+    goals.insert(GridLocation(1, 0));
+    EXPECT_FALSE(cache.find_nearest(GridLocation(0, 0), goals, 1, manhattan, found));
+}
+
+TEST(CompactPathTest, MergesRunsAndKeepsEveryStep) {
+    GridGraph<TestNode, 5, 5> graph;
+    load_map(graph, WALL_MAP);
+    auto steps = a_star_search(graph, GridLocation(0, 4), GridLocation(4, 4), manhattan);
+    auto path = CompactPath::from_waypoints(steps);
+    EXPECT_EQ(steps, path.steps());
+    EXPECT_EQ(GridLocation(0, 4), path.start());
+    EXPECT_EQ(GridLocation(4, 4), path.end());
+    // One move per turn of the way around the wall.
+    EXPECT_EQ(6u, path.moves());
+    EXPECT_LT(path.bytes(), steps.size() * sizeof(GridLocation));
+
+    // Waits stay, any-angle moves aren't merged and long moves are split.
+    std::vector<GridLocation> waypoints {GridLocation(0, 0), GridLocation(1, 1), GridLocation(1, 1),
+                                         GridLocation(3, 2), GridLocation(5, 3), GridLocation(305, 3)};
+    path = CompactPath::from_waypoints(waypoints);
+    ASSERT_EQ(7u, path.moves());
+    EXPECT_TRUE(path.move(1).is_wait());
+    EXPECT_FALSE(path.move(2).is_run());
+    std::vector<GridLocation> visited;
+    path.for_each_waypoint([&visited](const GridLocation& loc) { visited.push_back(loc); });
+    EXPECT_EQ(GridLocation(305, 3), visited.back());
+    EXPECT_EQ(8u, visited.size());
+    EXPECT_TRUE(CompactPath::from_waypoints({}).empty());
+}
+
+TEST(NearestTargetTest, PicksNearestByPathAndSkipsUnreachable) {
+    GridGraph<TestNode, 5, 5> graph;
+    load_map(graph, WALL_MAP);
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+
+    // (4, 4) is closer as the crow flies, but behind the wall.
+    std::vector<GridLocation> targets {GridLocation(4, 4), GridLocation(0, 0)};
+    auto path = path_to_nearest(graph, GridLocation(2, 4), targets, manhattan, workspace);
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(GridLocation(0, 0), path.back());
+
+    path = path_to_nearest(graph, GridLocation(4, 4), targets, manhattan, workspace);
+    ASSERT_EQ(1u, path.size());
+    EXPECT_EQ(GridLocation(4, 4), path.back());
+
+    targets = {GridLocation(1, 1)};
+    EXPECT_TRUE(path_to_nearest(graph, GridLocation(2, 4), targets, manhattan, workspace).empty());
+}
+
+TEST(CoveragePlanTest, SweepsCoverEveryReachableTile) {
+    using Graph = GridGraph<TestNode, 24, 24>;
+    std::unique_ptr<Graph> graph(new Graph);
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+
+    for (unsigned seed = 0; seed < 10; seed++) {
+        load_map(*graph, random_map(24, 24, 0.25, seed));
+        GridLocation start(0, 0);
+        while (!graph->passable(start)) {
+            start = GridLocation(std::get<0>(start) + 1, 0);
+        }
+        std::unordered_set<GridLocation> tiles;
+        for (int x = 2; x < 20; x++) {
+            for (int y = 3; y < 22; y++) {
+                tiles.insert(GridLocation(x, y));
+            }
+        }
+
+        std::unordered_set<GridLocation> reachable;
+        for (auto& tile : tiles) {
+            if (!a_star_search(*graph, start, tile, manhattan, workspace).empty()) {
+                reachable.insert(tile);
+            }
+        }
+
+        // Nearest cell first, as a patrolling lifeform goes.
+        std::vector<GridLocation> passable;
+        for (auto& tile : tiles) {
+            if (graph->passable(tile)) {
+                passable.push_back(tile);
+            }
+        }
+        CoveragePlan plan(passable);
+        std::vector<GridLocation> tour {start};
+        while (!plan.done()) {
+            auto leg = path_to_nearest(*graph, tour.back(), plan.entries(), manhattan, workspace);
+            if (leg.empty()) {
+                break;
+            }
+            tour.insert(tour.end(), leg.begin() + 1, leg.end());
+            auto sweep = plan.sweep(leg.back());
+            tour.insert(tour.end(), sweep.begin() + 1, sweep.end());
+        }
+        if (reachable.empty()) {
+            EXPECT_EQ(1u, tour.size());
+            continue;
+        }
+        expect_valid_path(*graph, tour);
+        std::unordered_set<GridLocation> covered(tour.begin(), tour.end());
+        for (auto& tile : tiles) {
+            EXPECT_EQ(reachable.count(tile), covered.count(tile));
+        }
+        // Sweeping only walks over a fraction of the tiles twice.
+        EXPECT_LT(tour.size(), 2 * reachable.size());
+    }
+}
+
+TEST(BitboardTest, BreadthFirstSearchesMatchDijkstra) {
+    // Wider than a word, so rows span several of them.
+    using Graph = GridGraph<TestNode, 70, 20>;
+    std::unique_ptr<Graph> graph(new Graph);
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> pos_x(0, 69), pos_y(0, 19);
+
+    for (unsigned seed = 0; seed < 5; seed++) {
+        load_map(*graph, random_map(70, 20, 0.3, seed));
+        auto& passable = graph->passable_bits();
+        GridLocation start(pos_x(rng), pos_y(rng));
+        if (!graph->passable(start)) {
+            continue;
+        }
+
+        dijkstra(*graph, {graph->index(start)}, workspace);
+        std::vector<int> distances;
+        bitbfs::distance_field(passable, start, distances);
+        auto region = bitbfs::flood(passable, start);
+        for (NodeIndex idx = 0; idx < graph->size(); idx++) {
+            int expected = workspace.reached(idx) ? workspace.cost(idx) : -1;
+            EXPECT_EQ(expected, distances[idx]);
+            EXPECT_EQ(workspace.reached(idx), region.test(graph->location(idx)));
+        }
+
+        std::vector<uint32_t> labels;
+        bitbfs::label_regions(passable, labels);
+        for (int query = 0; query < 20; query++) {
+            GridLocation goal(pos_x(rng), pos_y(rng));
+            bool same_region = labels[graph->index(goal)] == labels[graph->index(start)];
+            EXPECT_EQ(same_region, bitbfs::reachable(passable, start, goal));
+
+            Bitboard<70, 20> targets;
+            targets.set(goal);
+            targets.set(GridLocation(pos_x(rng), pos_y(rng)));
+            int expected = -1;
+            targets.for_each([&](int x, int y) {
+                int distance = distances[graph->index(GridLocation(x, y))];
+                if (distance >= 0 && (expected < 0 || distance < expected)) {
+                    expected = distance;
+                }
+            });
+            GridLocation found;
+            ASSERT_EQ(expected >= 0, bitbfs::nearest_target(passable, start, targets, found));
+            if (expected >= 0) {
+                EXPECT_EQ(expected, distances[graph->index(found)]);
+            }
+        }
+    }
+}
+
+TEST(HierarchicalGraphTest, FindsPathsWhereverAStarDoes) {
+    using Graph = GridGraph<TestNode, 40, 36>;
+    std::unique_ptr<Graph> graph(new Graph);
+    HierarchicalGraph<Graph> hierarchy(8);
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> coord_x(0, 39), coord_y(0, 35);
+
+    for (unsigned seed = 0; seed < 5; seed++) {
+        load_map(*graph, random_map(40, 36, 0.25, seed));
+        hierarchy.build(*graph);
+        EXPECT_LT(0u, hierarchy.node_count());
+        for (int query = 0; query < 40; query++) {
+            GridLocation start(coord_x(rng), coord_y(rng)), goal(coord_x(rng), coord_y(rng));
+            if (!graph->passable(start) || !graph->passable(goal)) {
+                continue;
+            }
+            auto optimal = a_star_search(*graph, start, goal, manhattan);
+            auto path = hierarchy.find_path(start, goal);
+            ASSERT_EQ(optimal.empty(), path.empty());
+            if (!path.empty()) {
+                EXPECT_EQ(start, path.front());
+                EXPECT_EQ(goal, path.back());
+                EXPECT_LE(optimal.size(), path.size());
+                expect_valid_path(*graph, path);
+            }
+        }
+    }
+}
+
+TEST(HierarchicalGraphTest, FindsPathAcrossClusters) {
+    using Graph = GridGraph<TestNode, 5, 5>;
+    Graph graph;
+    load_map(graph, WALL_MAP);
+    HierarchicalGraph<Graph> hierarchy(3);
+    hierarchy.build(graph);
+
+    auto path = hierarchy.find_path(GridLocation(0, 4), GridLocation(4, 4));
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(GridLocation(0, 4), path.front());
+    EXPECT_EQ(GridLocation(4, 4), path.back());
+    expect_valid_path(graph, path);
+}
+
+TEST(FirstMoveTableTest, GivesShortestPathsBetweenAllPairs) {
+    using Graph = GridGraph<TestNode, 20, 18>;
+    std::unique_ptr<Graph> graph(new Graph);
+    load_map(*graph, random_map(20, 18, 0.3, 3));
+    FirstMoveTable<Graph> table;
+    table.build(*graph, 3);
+    ASSERT_TRUE(table.built());
+    EXPECT_LT(table.run_count(), graph->size() * graph->size() / 4);
+
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+    for (NodeIndex from = 0; from < graph->size(); from += 7) {
+        for (NodeIndex to = 0; to < graph->size(); to += 5) {
+            auto start = graph->location(from), goal = graph->location(to);
+            if (!graph->passable(start) || !graph->passable(goal) ||
+                    graph->at(std::get<0>(start), std::get<1>(start))->region() !=
+                    graph->at(std::get<0>(goal), std::get<1>(goal))->region()) {
+                continue;
+            }
+            auto expected = a_star_search(*graph, start, goal, manhattan, workspace);
+            auto path = table.find_path(start, goal);
+            ASSERT_EQ(expected.size(), path.size());
+            EXPECT_EQ(goal, path.back());
+            expect_valid_path(*graph, path);
+        }
+    }
+}
+
+TEST(LandmarkHeuristicTest, IsAdmissibleAndKeepsPathsOptimal) {
+    using Graph = GridGraph<TestNode, 30, 30>;
+    std::unique_ptr<Graph> graph(new Graph);
+    load_map(*graph, random_map(30, 30, 0.35, 5));
+    LandmarkHeuristic<Graph> landmarks(3);
+    landmarks.build(*graph);
+    EXPECT_LT(0u, landmarks.landmark_count());
+
+    std::function<int(GridLocation, GridLocation)> alt = std::cref(landmarks);
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+    std::mt19937 rng(13);
+    std::uniform_int_distribution<int> coord(0, 29);
+    for (int query = 0; query < 200; query++) {
+        GridLocation start(coord(rng), coord(rng)), goal(coord(rng), coord(rng));
+        if (!graph->passable(start) || !graph->passable(goal)) {
+            continue;
+        }
+        auto expected = a_star_search(*graph, start, goal, manhattan, workspace);
+        if (expected.empty()) {
+            continue;
+        }
+        int distance = expected.size() - 1;
+        EXPECT_LE(landmarks(start, goal), distance);
+        EXPECT_LE(manhattan(start, goal), landmarks(start, goal));
+        EXPECT_EQ(expected.size(), a_star_search(*graph, start, goal, alt, workspace).size());
+    }
+}
+
+TEST(GridGraphTest, ReplaceRecomputesRegions) {
+    GridGraph<TestNode, 5, 5> graph;
+    load_map(graph, WALL_MAP);
+    EXPECT_EQ(graph.at(0, 4)->region(), graph.at(0, 0)->region());
+
+    graph.replace(2, 3, std::unique_ptr<TestNode>(new TestNode(false)));
+    EXPECT_FALSE(graph.passable(GridLocation(2, 3)));
+    EXPECT_NE(graph.at(0, 4)->region(), graph.at(0, 0)->region());
+    EXPECT_EQ(0u, graph.at(2, 3)->region());
+}
+
+TEST(GridGraphTest, EightConnectedMovesDontCutCorners) {
+    GridGraph<TestNode, 3, 3, 8> graph;
+    load_map(graph, "1 1 1\n1 1 2\n1 1 1\n");
+
+    std::vector<GridLocation> neighbors;
+    graph.for_each_neighbor(GridLocation(1, 1), [&](const GridLocation& next) { neighbors.push_back(next); });
+    // Not to (2, 1), nor diagonally past it to (2, 0) or (2, 2).
+    EXPECT_EQ(std::vector<GridLocation>({GridLocation(1, 0), GridLocation(0, 1), GridLocation(1, 2),
+                                         GridLocation(0, 0), GridLocation(0, 2)}), neighbors);
+    EXPECT_EQ(14, graph.cost(GridLocation(1, 1), GridLocation(0, 0)));
+    EXPECT_EQ(10, graph.cost(GridLocation(1, 1), GridLocation(1, 0)));
+
+    auto path = a_star_search(graph, GridLocation(1, 0), GridLocation(2, 2), OctileHeuristic<10, 14>());
+    EXPECT_EQ(30, path_cost(graph, path));
+}
+
+TEST(EightConnectedTest, SearchesAgreeOnPathCosts) {
+    using Graph = GridGraph<TestNode, 20, 20, 8>;
+    std::unique_ptr<Graph> graph(new Graph);
+    SearchWorkspace<int, BucketQueue<int> > workspace, backward;
+    Graph::Heuristic octile;
+    std::mt19937 rng(23);
+    std::uniform_int_distribution<int> coord(0, 19);
+
+    for (unsigned seed = 0; seed < 4; seed++) {
+        load_map(*graph, random_map(20, 20, 0.3, seed));
+        FirstMoveTable<Graph> table;
+        table.build(*graph, 2);
+        HierarchicalGraph<Graph> hierarchy(5);
+        hierarchy.build(*graph);
+        for (int query = 0; query < 25; query++) {
+            GridLocation start(coord(rng), coord(rng)), goal(coord(rng), coord(rng));
+            if (!graph->passable(start) || !graph->passable(goal)) {
+                continue;
+            }
+            auto expected = a_star_search(*graph, start, goal, octile, workspace);
+            auto jump_point = jump_point_search(*graph, start, goal, octile, workspace);
+            auto bidirectional = bidirectional_search(*graph, start, goal, octile, workspace, backward);
+            DStarLite<Graph> planner(*graph, goal);
+            auto incremental = planner.find_path(start);
+            FlowField<Graph> field;
+            field.build(*graph, goal);
+            auto flow = field.find_path(start);
+            auto hierarchical = hierarchy.find_path(start, goal);
+            ASSERT_EQ(expected.empty(), jump_point.empty());
+            ASSERT_EQ(expected.empty(), bidirectional.empty());
+            ASSERT_EQ(expected.empty(), incremental.empty());
+            ASSERT_EQ(expected.empty(), flow.empty());
+            ASSERT_EQ(expected.empty(), hierarchical.empty());
+            if (expected.empty()) {
+                continue;
+            }
+            int cost = path_cost(*graph, expected);
+            EXPECT_EQ(cost, path_cost(*graph, jump_point));
+            EXPECT_EQ(cost, path_cost(*graph, bidirectional));
+            EXPECT_EQ(cost, path_cost(*graph, incremental));
+            EXPECT_EQ(cost, path_cost(*graph, flow));
+            EXPECT_EQ(cost, path_cost(*graph, table.find_path(start, goal)));
+            // Near optimal only.
+            EXPECT_LE(cost, path_cost(*graph, hierarchical));
+            EXPECT_LE(octile(start, goal), cost);
+        }
+    }
+}
+
+TEST(WeightedTerrainTest, PathsAvoidCostlyTiles) {
+    GridGraph<TestNode, 5, 3> graph;
+    load_map(graph, "1 1 1 1 1\n1 3 3 3 1\n1 1 1 1 1\n");
+    EXPECT_FALSE(graph.uniform_costs());
+    EXPECT_EQ(graph.at(0, 0)->region(), graph.at(2, 1)->region());
+    EXPECT_EQ(2, graph.cost(GridLocation(0, 1), GridLocation(1, 1)));
+    EXPECT_EQ(2, graph.cost(GridLocation(1, 1), GridLocation(0, 1)));
+
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+    auto path = jump_point_search(graph, GridLocation(0, 1), GridLocation(4, 1), manhattan, workspace);
+    EXPECT_EQ(6, path_cost(graph, path));
+    EXPECT_EQ(7u, path.size());
+    EXPECT_FALSE(line_of_sight(graph, GridLocation(0, 0), GridLocation(4, 2)));
+
+    graph.replace(2, 0, std::unique_ptr<TestNode>(new TestNode(true, 3)));
+    graph.replace(2, 2, std::unique_ptr<TestNode>(new TestNode(true, 3)));
+    path = a_star_search(graph, GridLocation(0, 1), GridLocation(4, 1), manhattan, workspace);
+    EXPECT_EQ(8, path_cost(graph, path));
+
+    for (int x = 0; x < 5; x++) {
+        for (int y = 0; y < 3; y++) {
+            graph.replace(x, y, std::unique_ptr<TestNode>(new TestNode(true)));
+        }
+    }
+    EXPECT_TRUE(graph.uniform_costs());
+}
+
+TEST(WeightedTerrainTest, SearchesAgreeOnPathCosts) {
+    using Graph = GridGraph<TestNode, 20, 20, 8>;
+    std::unique_ptr<Graph> graph(new Graph);
+    SearchWorkspace<int, BucketQueue<int> > workspace, backward;
+    Graph::Heuristic octile;
+    std::mt19937 rng(29);
+    std::uniform_int_distribution<int> coord(0, 19);
+
+    for (unsigned seed = 0; seed < 4; seed++) {
+        load_map(*graph, random_map(20, 20, 0.2, seed, 0.3));
+        LandmarkHeuristic<Graph> landmarks(2);
+        landmarks.build(*graph);
+        for (int query = 0; query < 25; query++) {
+            GridLocation start(coord(rng), coord(rng)), goal(coord(rng), coord(rng));
+            if (!graph->passable(start) || !graph->passable(goal)) {
+                continue;
+            }
+            auto dijkstra = a_star_search(*graph, start, goal, [](const GridLocation&, const GridLocation&) { return 0; }, workspace);
+            auto expected = a_star_search(*graph, start, goal, octile, workspace);
+            auto alt = a_star_search(*graph, start, goal, std::cref(landmarks), workspace);
+            auto bidirectional = bidirectional_search(*graph, start, goal, octile, workspace, backward);
+            DStarLite<Graph> planner(*graph, goal);
+            auto incremental = planner.find_path(start);
+            FlowField<Graph> field;
+            field.build(*graph, goal);
+            auto flow = field.find_path(start);
+            ASSERT_EQ(dijkstra.empty(), expected.empty());
+            if (expected.empty()) {
+                continue;
+            }
+            int cost = path_cost(*graph, dijkstra);
+            EXPECT_EQ(cost, path_cost(*graph, expected));
+            EXPECT_EQ(cost, path_cost(*graph, alt));
+            EXPECT_EQ(cost, path_cost(*graph, bidirectional));
+            EXPECT_EQ(cost, path_cost(*graph, incremental));
+            EXPECT_EQ(cost, path_cost(*graph, flow));
+            EXPECT_LE(octile(start, goal), cost);
+            EXPECT_LE(landmarks(start, goal), cost);
+        }
+    }
+}
+
+// Only the straight moves of an 8-connected graph, at three times the cost.
+struct StraightNeighbors {
+    template<typename Graph, typename Visitor>
+    void operator()(const Graph& graph, const GridLocation& loc, Visitor visit) const {
+        graph.for_each_neighbor(loc, [&](const GridLocation& next) {
+            if (std::get<0>(next) == std::get<0>(loc) || std::get<1>(next) == std::get<1>(loc)) {
+                visit(next);
+            }
+        });
+    }
+};
+
+struct TripledCost {
+    template<typename Graph>
+    int operator()(const Graph& graph, const GridLocation& from, const GridLocation& to) const {
+        return 3 * graph.cost(from, to) / Graph::STRAIGHT_COST;
+    }
+};
+
+TEST(AStarSearchTest, PoliciesStandInForGraphCostAndNeighbors) {
+    using Graph = GridGraph<TestNode, 24, 24, 8>;
+    using StraightGraph = GridGraph<TestNode, 24, 24>;
+    std::unique_ptr<Graph> graph(new Graph);
+    std::unique_ptr<StraightGraph> straight(new StraightGraph);
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+    std::mt19937 rng(13);
+    std::uniform_int_distribution<int> coord(0, 23);
+
+    for (unsigned seed = 0; seed < 3; seed++) {
+        const std::string map = random_map(24, 24, 0.25, seed, 0.2);
+        load_map(*graph, map);
+        load_map(*straight, map);
+        for (int query = 0; query < 20; query++) {
+            GridLocation start(coord(rng), coord(rng)), goal(coord(rng), coord(rng));
+            if (!graph->passable(start) || !graph->passable(goal)) {
+                continue;
+            }
+            auto expected = a_star_search(*straight, start, goal, ManhattanHeuristic<>(), workspace);
+            auto path = a_star_search(*graph, start, goal, ManhattanHeuristic<3>(), workspace,
+                                      TripledCost(), StraightNeighbors());
+            ASSERT_EQ(expected.empty(), path.empty());
+            if (!path.empty()) {
+                expect_valid_path(*straight, path);
+                EXPECT_EQ(path_cost(*straight, expected), path_cost(*straight, path));
+                EXPECT_EQ(3 * path_cost(*straight, expected), workspace.cost(graph->index(goal)));
+            }
+        }
+    }
+}
+
+TEST(NearestTargetTest, PathToNearestMatchesDijkstra) {
+    using Graph = GridGraph<TestNode, 24, 24, 8>;
+    std::unique_ptr<Graph> graph(new Graph);
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+    std::mt19937 rng(31);
+    std::uniform_int_distribution<int> coord(0, 23);
+
+    for (unsigned seed = 0; seed < 4; seed++) {
+        load_map(*graph, random_map(24, 24, 0.25, seed, 0.2));
+        for (int query = 0; query < 20; query++) {
+            GridLocation start(coord(rng), coord(rng));
+            if (!graph->passable(start)) {
+                continue;
+            }
+            std::unordered_set<GridLocation> goals;
+            for (int goal = 0; goal < 5; goal++) {
+                goals.insert(GridLocation(coord(rng), coord(rng)));
+            }
+            dijkstra(*graph, {graph->index(start)}, workspace);
+            bool found = false;
+            int expected = 0;
+            for (auto& goal : goals) {
+                NodeIndex idx = graph->index(goal);
+                if (workspace.reached(idx) && (!found || workspace.cost(idx) < expected)) {
+                    found = true;
+                    expected = workspace.cost(idx);
+                }
+            }
+
+            auto path = path_to_nearest(*graph, start, goals, Graph::Heuristic(), workspace);
+            ASSERT_EQ(found, !path.empty());
+            if (found) {
+                EXPECT_EQ(start, path.front());
+                EXPECT_EQ(1u, goals.count(path.back()));
+                EXPECT_EQ(expected, path_cost(*graph, path));
+            }
+        }
+    }
+}
+
+TEST(ResumableSearchTest, FindsNearestOfSeveralGoals) {
+    using Graph = GridGraph<TestNode, 24, 24>;
+    using Search = ResumableSearch<Graph>;
+    std::unique_ptr<Graph> graph(new Graph);
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+    std::mt19937 rng(29);
+    std::uniform_int_distribution<int> coord(0, 23);
+
+    for (unsigned seed = 0; seed < 5; seed++) {
+        load_map(*graph, random_map(24, 24, 0.3, seed));
+        for (int query = 0; query < 20; query++) {
+            GridLocation start(coord(rng), coord(rng));
+            if (!graph->passable(start)) {
+                continue;
+            }
+            std::unordered_set<GridLocation> goals;
+            for (int goal = 0; goal < 5; goal++) {
+                goals.insert(GridLocation(coord(rng), coord(rng)));
+            }
+            Search search(*graph, start, goals, manhattan);
+            while (search.status() == Search::SEARCHING) {
+                search.step(7);
+            }
+
+            auto expected = path_to_nearest(*graph, start, goals, manhattan, workspace);
+            ASSERT_EQ(expected.empty() ? Search::NOT_FOUND : Search::FOUND, search.status());
+            if (!expected.empty()) {
+                auto path = search.path();
+                EXPECT_EQ(start, path.front());
+                EXPECT_EQ(search.goal(), path.back());
+                EXPECT_EQ(1u, goals.count(path.back()));
+                EXPECT_EQ(path_cost(*graph, expected), path_cost(*graph, path));
+                expect_valid_path(*graph, path);
+            }
+        }
+    }
+}
+
+TEST(DStarLiteTest, RepairsPathAfterTerrainChanges) {
+    using Graph = GridGraph<TestNode, 20, 20>;
+    std::unique_ptr<Graph> graph(new Graph);
+    load_map(*graph, random_map(20, 20, 0.2, 9));
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> coord(0, 19);
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+
+    GridLocation start(0, 0), goal(19, 19);
+    graph->replace(0, 0, std::unique_ptr<TestNode>(new TestNode(true)));
+    graph->replace(19, 19, std::unique_ptr<TestNode>(new TestNode(true)));
+    DStarLite<Graph> planner(*graph, goal);
+
+    for (int step = 0; step < 30; step++) {
+        auto expected = a_star_search(*graph, start, goal, manhattan, workspace);
+        auto path = planner.find_path(start);
+        ASSERT_EQ(expected.size(), path.size());
+        expect_valid_path(*graph, path);
+        if (path.size() > 2) {
+            start = path[1]; // the agent moves on
+        }
+
+        // Flip a random tile, sometimes one on the current path.
+        GridLocation changed = path.size() > 3 && step % 2 ? path[path.size() / 2]
+                                                           : GridLocation(coord(rng), coord(rng));
+        if (changed == start || changed == goal) {
+            continue;
+        }
+        bool passable = graph->passable(changed);
+        graph->replace(std::get<0>(changed), std::get<1>(changed),
+                       std::unique_ptr<TestNode>(new TestNode(!passable)));
+        planner.notify_changed(changed);
+    }
+}
+
+TEST(DStarLiteTest, ResetPlansTowardsNewGoal) {
+    using Graph = GridGraph<TestNode, 20, 20>;
+    std::unique_ptr<Graph> graph(new Graph);
+    load_map(*graph, random_map(20, 20, 0.2, 4));
+    std::mt19937 rng(23);
+    std::uniform_int_distribution<int> coord(0, 19);
+    SearchWorkspace<int, BucketQueue<int> > workspace;
+
+    DStarLite<Graph> planner(*graph, GridLocation(0, 0));
+    for (int query = 0; query < 20; query++) {
+        GridLocation start(coord(rng), coord(rng)), goal(coord(rng), coord(rng));
+        if (!graph->passable(start) || !graph->passable(goal)) {
+            continue;
+        }
+        planner.reset(goal);
+        EXPECT_EQ(goal, planner.goal());
+        auto expected = a_star_search(*graph, start, goal, manhattan, workspace);
+        auto path = planner.find_path(start);
+        ASSERT_EQ(expected.size(), path.size());
+        expect_valid_path(*graph, path);
+    }
+}
+
+TEST(SearchStatsTest, RecorderCountsOneSearch) {
+    GridGraph<TestNode, 5, 5> graph;
+    load_map(graph, WALL_MAP);
+    SearchWorkspace<int, BucketQueue<int>, SearchRecorder<true> > workspace;
+
+    a_star_search(graph, GridLocation(0, 0), GridLocation(4, 4), manhattan, workspace);
+    auto path = a_star_search(graph, GridLocation(0, 4), GridLocation(4, 4), manhattan, workspace);
+    auto stats = workspace.stats.stats();
+    EXPECT_EQ(1u, stats.searches);
+    EXPECT_EQ(path.size(), stats.path_length);
+    EXPECT_EQ(stats.expanded + 1, stats.pops); // the goal is popped, not expanded
+    EXPECT_LE(stats.pops, stats.pushes + 1); // the start isn't pushed by a search step
+    EXPECT_GE(stats.ms, 0);
+
+    SearchStats total;
+    total += stats;
+    total += stats;
+    EXPECT_EQ(2u, total.searches);
+    EXPECT_EQ(2 * stats.expanded, total.expanded);
+
+    SearchWorkspace<int, BucketQueue<int>, SearchRecorder<false> > quiet;
+    a_star_search(graph, GridLocation(0, 4), GridLocation(4, 4), manhattan, quiet);
+    EXPECT_EQ(0u, quiet.stats.stats().searches);
+    EXPECT_EQ(0u, quiet.stats.stats().expanded);
+}
+
+TEST(RegionBoundariesTest, FindsClosestTileOfRegion) {
+    // Not a whole number of blocks either way.
+    using Graph = GridGraph<TestNode, 37, 29>;
+    std::unique_ptr<Graph> graph(new Graph);
+    RegionBoundaries<Graph> boundaries;
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> x_coord(0, 36), y_coord(0, 28);
+
+    for (unsigned seed = 0; seed < 4; seed++) {
+        load_map(*graph, random_map(37, 29, 0.45, seed));
+        boundaries.build(*graph);
+        for (int query = 0; query < 40; query++) {
+            GridLocation start(x_coord(rng), y_coord(rng)), goal(x_coord(rng), y_coord(rng));
+            const uint32_t region = graph->at(std::get<0>(start), std::get<1>(start))->region();
+            if (!graph->passable(start) ||
+                    graph->at(std::get<0>(goal), std::get<1>(goal))->region() == region) {
+                continue;
+            }
+            // Every tile of the region, first of the closest wins.
+            long best = -1;
+            GridLocation expected;
+            for (int y = 0; y < 29; y++) {
+                for (int x = 0; x < 37; x++) {
+                    long dx = x - std::get<0>(goal), dy = y - std::get<1>(goal);
+                    if (graph->at(x, y)->region() == region && (best < 0 || dx * dx + dy * dy < best)) {
+                        best = dx * dx + dy * dy;
+                        expected = GridLocation(x, y);
+                    }
+                }
+            }
+
+            GridLocation tile;
+            ASSERT_TRUE(boundaries.closest(*graph, region, goal, tile));
+            EXPECT_EQ(expected, tile);
+            EXPECT_FALSE(a_star_search(*graph, start, tile, manhattan).empty());
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}